@@ -0,0 +1,805 @@
+#include "CpmMachine.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+
+
+namespace {
+    /* Records of 128 bytes, 128 of them to an extent, 32 extents to a module */
+    constexpr int recordSize = 128;
+    constexpr uint16_t defaultDma = 0x0080;
+    constexpr uint16_t fcb1 = 0x005C;
+    constexpr uint16_t fcb2 = 0x006C;
+
+    /* BIOS layout: the jump table, the trapped stubs it leads to, a disk parameter block and an
+     * allocation vector for the programs asking for them, and the loop a finished program waits in */
+    constexpr int biosFunctions = 17;
+    constexpr uint16_t biosStubs = CpmMachine::biosAddress + 0x40;
+    constexpr int biosStubSize = 6;
+    constexpr uint16_t dpbAddress = CpmMachine::biosAddress + 0xC0;
+    constexpr uint16_t allocationAddress = CpmMachine::biosAddress + 0xD0;
+    constexpr uint16_t exitLoop = CpmMachine::biosAddress + 0xF0;
+
+    /* Cycles run between checks for the end of the program */
+    constexpr uint64_t runSlice = 1 << 16;
+
+    /* FCB fields */
+    constexpr int fcbExtent = 12;
+    constexpr int fcbModule = 14;
+    constexpr int fcbRecordCount = 15;
+    constexpr int fcbHandle = 16;
+    constexpr int fcbRecord = 32;
+    constexpr int fcbRandom = 33;
+    constexpr int fcbSize = 36;
+
+    void putWord(uint8_t* at, uint16_t value) {
+        at[0] = value & 0xFF;
+        at[1] = value >> 8;
+    }
+
+    uint32_t currentRecord(const uint8_t* fcb) {
+        return (fcb[fcbModule] & 0x3F) * 4096 + (fcb[fcbExtent] & 0x1F) * 128 + fcb[fcbRecord];
+    }
+
+    void setCurrentRecord(uint8_t* fcb, uint32_t record) {
+        fcb[fcbRecord] = record & 0x7F;
+        fcb[fcbExtent] = (record >> 7) & 0x1F;
+        fcb[fcbModule] = static_cast<uint8_t>(record >> 12);
+    }
+
+    /* Records of the current extent, for the record count of the FCB */
+    uint8_t extentRecords(const uint8_t* fcb, const std::string& path) {
+        std::error_code error;
+        uint64_t size = std::filesystem::file_size(path, error);
+        if (error)
+            return 0;
+        uint64_t records = (size + recordSize - 1) / recordSize;
+        uint64_t extentStart = currentRecord(fcb) & ~0x7Fu;
+        return static_cast<uint8_t>(records <= extentStart ? 0 : std::min<uint64_t>(records - extentStart, 128));
+    }
+
+    /* The 11 name characters of an 8.3 host file name, false when it has no such form */
+    bool shortName(const std::string& name, char padded[11]) {
+        size_t dot = name.find('.');
+        std::string base = name.substr(0, dot);
+        std::string type = dot == std::string::npos ? "" : name.substr(dot + 1);
+        if (base.empty() || base.size() > 8 || type.size() > 3 || type.find('.') != std::string::npos)
+            return false;
+
+        memset(padded, ' ', 11);
+        for (size_t i = 0; i < base.size(); i++)
+            padded[i] = static_cast<char>(toupper(static_cast<unsigned char>(base[i])));
+        for (size_t i = 0; i < type.size(); i++)
+            padded[8 + i] = static_cast<char>(toupper(static_cast<unsigned char>(type[i])));
+        return true;
+    }
+
+    /* Whether the 11 name characters of an FCB make a CP/M file name: printable characters without
+     * the delimiters, and no path separators or dots that would lead the host outside its directory.
+     * Spaces only pad the end of a field */
+    bool validName(const uint8_t* fcb, bool wildcards) {
+        for (int field = 1; field <= 9; field += 8) {
+            int end = field == 1 ? 9 : 12;
+            bool padding = false;
+            for (int i = field; i < end; i++) {
+                char character = static_cast<char>(fcb[i] & 0x7F);
+                if (character == ' ') {
+                    padding = true;
+                    continue;
+                }
+                if (padding || character < ' ' || character == 0x7F || strchr("/\\.:,;=<>[]*|\"", character) ||
+                    (character == '?' && !wildcards))
+                    return false;
+            }
+        }
+        return (fcb[1] & 0x7F) != ' ';
+    }
+
+    /* A command line argument as an FCB: drive, name and type, * standing for question marks */
+    void parseFcb(const std::string& word, uint8_t* fcb) {
+        memset(fcb + 1, ' ', 11);
+        size_t start = 0;
+        if (word.size() >= 2 && word[1] == ':') {
+            fcb[0] = static_cast<uint8_t>(word[0] - 'A' + 1);
+            start = 2;
+        }
+
+        int field = 1;
+        int end = 9;
+        for (size_t i = start; i < word.size(); i++) {
+            if (word[i] == '.') {
+                field = 9;
+                end = 12;
+            }
+            else if (word[i] == '*') {
+                while (field < end)
+                    fcb[field++] = '?';
+            }
+            else if (field < end)
+                fcb[field++] = static_cast<uint8_t>(word[i]);
+        }
+    }
+}
+
+
+template <class Policies>
+class CpmMachine::ProcessorOf : public CpmMachine::Processor
+{
+public:
+    ProcessorOf(uint8_t* memory, CpmMachine* machine) : cpu(memory, tpaStart)
+    {
+        cpu.SetIOHandlers(nullptr, portOut, machine);
+    }
+
+    StopReason RunUntil(uint64_t cycle) override { return cpu.RunUntil(cycle); }
+    uint64_t Cycles() const override { return cpu.Cycles(); }
+    void SetCycles(uint64_t count) override { cpu.SetCycles(count); }
+    uint16_t ProgramCounter() const override { return cpu.ProgramCounter(); }
+    CpuState State() const override { return cpu.State(); }
+    void SetState(const CpuState& state) override { cpu.SetState(state); }
+
+private:
+    Emulator8080<Policies> cpu;
+};
+
+CpmMachine::CpmMachine(CpuModel model) : memory(0x10000, 0), directory("."),
+    inputPosition(0), inputFile(nullptr), echo(nullptr), dma(defaultDma), disk(0), user(0), searchPosition(0),
+    finished(false), exitCycles(0)
+{
+    if (model == CpuModel::Z80)
+        cpu = std::make_unique<ProcessorOf<Z80Policies>>(memory.data(), this);
+    else if (model == CpuModel::Intel8085)
+        cpu = std::make_unique<ProcessorOf<Intel8085Policies>>(memory.data(), this);
+    else
+        cpu = std::make_unique<ProcessorOf<ProductionPolicies>>(memory.data(), this);
+}
+
+CpmMachine::~CpmMachine() {
+    for (OpenFile& file : files) {
+        if (file.file)
+            fclose(file.file);
+    }
+}
+
+/* Set up the system in memory and load the program at 0x0100, with the arguments as its command
+ * tail and first two FCBs */
+bool CpmMachine::Load(const std::string& path, const std::string& arguments) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file)
+        return false;
+
+    for (OpenFile& open : files) {
+        if (open.file)
+            fclose(open.file);
+    }
+    files.clear();
+    std::fill(memory.begin(), memory.end(), 0);
+    size_t size = fread(&memory[tpaStart], 1, bdosAddress - tpaStart, file);
+    fclose(file);
+
+    /* Warm boot through the BIOS, BDOS at the top of the TPA, then the trapped entries */
+    memory[0x0000] = 0xC3;
+    putWord(&memory[0x0001], biosAddress + 3);
+    memory[0x0005] = 0xC3;
+    putWord(&memory[0x0006], bdosAddress);
+    memory[bdosAddress] = 0xD3;
+    memory[bdosAddress + 2] = 0xC9;
+    for (int function = 0; function < biosFunctions; function++) {
+        uint16_t stub = biosStubs + function * biosStubSize;
+        memory[biosAddress + function * 3] = 0xC3;
+        putWord(&memory[biosAddress + function * 3 + 1], stub);
+        memory[stub] = 0xD3;
+        if (function <= 1) {
+            memory[stub + 2] = 0xC3;
+            putWord(&memory[stub + 3], exitLoop);
+        }
+        else
+            memory[stub + 2] = 0xC9;
+    }
+    memory[exitLoop] = 0xC3;
+    putWord(&memory[exitLoop + 1], exitLoop);
+
+    /* 8" single density: 26 sectors per track, 1 KiB blocks, 243 of them, 64 directory entries */
+    const uint8_t dpb[15] = { 26, 0, 3, 7, 0, 242, 0, 63, 0, 0xC0, 0, 16, 0, 2, 0 };
+    memcpy(&memory[dpbAddress], dpb, sizeof(dpb));
+
+    std::string tail;
+    for (char ch : arguments)
+        tail += static_cast<char>(toupper(static_cast<unsigned char>(ch)));
+    std::istringstream words(tail);
+    std::string word;
+    memset(&memory[fcb1 + 1], ' ', 11);
+    memset(&memory[fcb2 + 1], ' ', 11);
+    if (words >> word)
+        parseFcb(word, &memory[fcb1]);
+    if (words >> word)
+        parseFcb(word, &memory[fcb2]);
+    if (!tail.empty())
+        tail = " " + tail.substr(0, 126);
+    memory[defaultDma] = static_cast<uint8_t>(tail.size());
+    memcpy(&memory[defaultDma + 1], tail.data(), tail.size());
+
+    /* The program may return to CP/M from its first stack frame */
+    CpuState start;
+    start.pc = tpaStart;
+    start.sp = bdosAddress - 2;
+    cpu->SetState(start);
+    cpu->SetCycles(0);
+
+    dma = defaultDma;
+    disk = 0;
+    user = 0;
+    output.clear();
+    inputPosition = 0;
+    finished = false;
+    exitCycles = 0;
+    return size > 0;
+}
+
+/* Host directory holding the files of the disks */
+void CpmMachine::SetDirectory(const std::string& path) {
+    directory = path;
+}
+
+/* Console input, a line feed taken as the return key. After its end the console reads ^Z */
+void CpmMachine::SetInput(const std::string& text) {
+    input = text;
+    inputPosition = 0;
+    inputFile = nullptr;
+}
+
+void CpmMachine::SetInputFile(FILE* file) {
+    inputFile = file;
+}
+
+/* Write the console output to the file as it comes, instead of keeping it for Output */
+void CpmMachine::SetEcho(FILE* file) {
+    echo = file;
+}
+
+/* Run until the program ends or the clock reaches the limit. Returns whether the program ended */
+bool CpmMachine::Run(uint64_t maxCycles) {
+    while (!finished && cpu->Cycles() < maxCycles) {
+        /* Nothing interrupts the CPU, so a HLT ends the program */
+        if (cpu->RunUntil(std::min(cpu->Cycles() + runSlice, maxCycles)) == StopReason::Halt)
+            finish();
+    }
+    return finished;
+}
+
+bool CpmMachine::Finished() const {
+    return finished;
+}
+
+/* Cycles run by the program, up to its end when it ended */
+uint64_t CpmMachine::Cycles() const {
+    return finished ? exitCycles : cpu->Cycles();
+}
+
+const std::string& CpmMachine::Output() const {
+    return output;
+}
+
+/* Registers of the CPU, between runs */
+CpuState CpmMachine::State() const {
+    return cpu->State();
+}
+
+uint8_t* CpmMachine::Memory() {
+    return memory.data();
+}
+
+/* Only the OUT instructions of the BDOS and BIOS entries are calls, the program's own are ignored */
+void CpmMachine::portOut(void* context, uint8_t, uint8_t) {
+    auto* machine = static_cast<CpmMachine*>(context);
+    uint16_t pc = machine->cpu->ProgramCounter();
+
+    if (pc == bdosAddress)
+        machine->bdos();
+    else if (pc >= biosStubs && pc < biosStubs + biosFunctions * biosStubSize && (pc - biosStubs) % biosStubSize == 0)
+        machine->bios((pc - biosStubs) / biosStubSize);
+}
+
+void CpmMachine::finish() {
+    finished = true;
+    exitCycles = cpu->Cycles();
+}
+
+/* The function in C, the parameter in DE or E. Results go to A and L, 16-bit ones to HL with a copy in
+ * BA, as programs written for either convention expect */
+void CpmMachine::bdos() {
+    state = cpu->State();
+    uint16_t parameter = (state.d << 8) | state.e;
+    uint16_t result = 0;
+
+    /* The file calls take an FCB at DE, one running past the top of memory is refused */
+    uint8_t function = state.c;
+    bool takesFcb = (function >= 15 && function <= 23 && function != 18) || (function >= 33 && function <= 36) ||
+                    function == 40;
+    if (takesFcb && parameter > 0x10000 - fcbSize)
+        function = 0xFF;
+
+    switch (function) {
+        case 0:
+            /* Return into the exit loop instead of the caller */
+            finish();
+            putWord(&memory[state.sp], exitLoop);
+            break;
+        case 1:
+            result = consoleRead();
+            if (result >= ' ' || result == '\r' || result == '\n' || result == '\t')
+                consoleWrite(static_cast<uint8_t>(result));
+            break;
+        case 2:
+            consoleWrite(state.e);
+            break;
+        case 3:
+            result = 0x1A;
+            break;
+        case 6:
+            if (state.e == 0xFF)
+                result = consoleReady() ? consoleRead() : 0;
+            else if (state.e == 0xFE)
+                result = consoleReady() ? 0xFF : 0;
+            else
+                consoleWrite(state.e);
+            break;
+        case 7:
+            result = memory[0x0003];
+            break;
+        case 8:
+            memory[0x0003] = state.e;
+            break;
+        case 9:
+            /* A string without its '$' ends after going once around memory */
+            for (uint32_t count = 0; count < 0x10000 && memory[(parameter + count) & 0xFFFF] != '$'; count++)
+                consoleWrite(memory[(parameter + count) & 0xFFFF]);
+            break;
+        case 10:
+            readLine(parameter);
+            break;
+        case 11:
+            result = consoleReady() ? 0xFF : 0;
+            break;
+        case 12:
+            result = 0x0022;
+            break;
+        case 13:
+            dma = defaultDma;
+            disk = 0;
+            break;
+        case 14:
+            disk = state.e;
+            break;
+        case 15:
+            result = openFile(parameter);
+            break;
+        case 16:
+            closeFile(&memory[parameter]);
+            break;
+        case 17:
+            result = search(true);
+            break;
+        case 18:
+            result = search(false);
+            break;
+        case 19:
+            result = deleteFiles(parameter);
+            break;
+        case 20:
+            result = transfer(parameter, false, false);
+            break;
+        case 21:
+            result = transfer(parameter, true, false);
+            break;
+        case 22:
+            result = makeFile(parameter);
+            break;
+        case 23:
+            result = renameFile(parameter);
+            break;
+        case 24:
+            result = 0x0001;
+            break;
+        case 25:
+            result = disk;
+            break;
+        case 26:
+            dma = parameter;
+            break;
+        case 27:
+            result = allocationAddress;
+            break;
+        case 31:
+            result = dpbAddress;
+            break;
+        case 32:
+            if (state.e == 0xFF)
+                result = user;
+            else
+                user = state.e & 0x0F;
+            break;
+        case 33:
+            result = transfer(parameter, false, true);
+            break;
+        case 34:
+        case 40:
+            result = transfer(parameter, true, true);
+            break;
+        case 35:
+            fileSize(parameter);
+            break;
+        case 36:
+            setRandomRecord(parameter);
+            break;
+        case 4:
+        case 5:
+        case 28:
+        case 29:
+        case 30:
+            break;
+        default:
+            result = 0xFF;
+            break;
+    }
+
+    state.l = result & 0xFF;
+    state.h = result >> 8;
+    state.a = state.l;
+    state.b = state.h;
+    cpu->SetState(state);
+}
+
+/* The console and list entries, the disk entries fail as there is no disk to drive directly */
+void CpmMachine::bios(int function) {
+    state = cpu->State();
+    switch (function) {
+        case 0:
+        case 1:
+            finish();
+            break;
+        case 2:
+            state.a = consoleReady() ? 0xFF : 0;
+            break;
+        case 3:
+            state.a = consoleRead();
+            break;
+        case 4:
+            consoleWrite(state.c);
+            break;
+        case 7:
+            state.a = 0x1A;
+            break;
+        case 9:
+            state.h = 0;
+            state.l = 0;
+            break;
+        case 13:
+        case 14:
+            state.a = 1;
+            break;
+        case 15:
+            state.a = 0xFF;
+            break;
+        case 16:
+            state.h = state.b;
+            state.l = state.c;
+            break;
+        default:
+            break;
+    }
+    cpu->SetState(state);
+}
+
+bool CpmMachine::consoleReady() {
+    if (inputFile)
+        return !feof(inputFile);
+    return inputPosition < input.size();
+}
+
+/* Host line ends become a single carriage return */
+uint8_t CpmMachine::consoleRead() {
+    while (true) {
+        int character;
+        if (inputFile)
+            character = fgetc(inputFile);
+        else
+            character = inputPosition < input.size() ? static_cast<uint8_t>(input[inputPosition++]) : EOF;
+
+        if (character == EOF)
+            return 0x1A;
+        if (character == '\r')
+            continue;
+        return character == '\n' ? '\r' : static_cast<uint8_t>(character);
+    }
+}
+
+void CpmMachine::consoleWrite(uint8_t character) {
+    if (echo)
+        fputc(character, echo);
+    else
+        output += static_cast<char>(character);
+}
+
+/* Read a line into the buffer: its size first, then the length read, then the characters */
+void CpmMachine::readLine(uint16_t buffer) {
+    uint8_t size = memory[buffer];
+    uint8_t length = 0;
+    while (true) {
+        uint8_t character = consoleRead();
+        if (character == '\r' || (character == 0x1A && length == 0))
+            break;
+        if ((character == 0x08 || character == 0x7F) && length > 0) {
+            --length;
+            consoleWrite(0x08);
+            consoleWrite(' ');
+            consoleWrite(0x08);
+        }
+        else if (length < size) {
+            memory[static_cast<uint16_t>(buffer + 2 + length++)] = character;
+            consoleWrite(character);
+        }
+    }
+    memory[static_cast<uint16_t>(buffer + 1)] = length;
+    consoleWrite('\r');
+}
+
+/* NAME.TYP of the FCB, without the attribute bits */
+std::string CpmMachine::fcbName(const uint8_t* fcb) {
+    std::string name;
+    std::string type;
+    for (int i = 1; i <= 8; i++)
+        name += static_cast<char>(fcb[i] & 0x7F);
+    for (int i = 9; i <= 11; i++)
+        type += static_cast<char>(fcb[i] & 0x7F);
+    name.erase(name.find_last_not_of(' ') + 1);
+    type.erase(type.find_last_not_of(' ') + 1);
+    return type.empty() ? name : name + "." + type;
+}
+
+/* Whether a host file name fits the FCB, question marks matching any character */
+bool CpmMachine::matches(const uint8_t* fcb, const std::string& name) {
+    char padded[11];
+    if (!shortName(name, padded))
+        return false;
+    for (int i = 0; i < 11; i++) {
+        char wanted = static_cast<char>(toupper(fcb[1 + i] & 0x7F));
+        if (wanted != '?' && wanted != padded[i])
+            return false;
+    }
+    return true;
+}
+
+/* Host files of the directory fitting the FCB, in name order */
+std::vector<std::string> CpmMachine::findFiles(const uint8_t* fcb) const {
+    std::vector<std::string> found;
+    if (!validName(fcb, true))
+        return found;
+
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        std::string name = entry.path().filename().string();
+        if (entry.is_regular_file(error) && matches(fcb, name))
+            found.push_back(name);
+    }
+    std::sort(found.begin(), found.end());
+    return found;
+}
+
+/* Path of a file of the directory, empty when the name would resolve to anywhere else */
+std::string CpmMachine::hostPath(const std::string& name) const {
+    std::error_code error;
+    std::filesystem::path base = std::filesystem::weakly_canonical(directory, error);
+    if (error)
+        return "";
+    std::filesystem::path path = std::filesystem::weakly_canonical(base / name, error);
+    if (error || path.parent_path() != base)
+        return "";
+    return path.string();
+}
+
+/* The open file of the FCB. Its slot number is kept in the allocation map of the FCB, which the
+ * host has no other use for, and checked against the name in case the program copied the FCB */
+CpmMachine::OpenFile* CpmMachine::fileOf(uint8_t* fcb, bool open) {
+    std::string name = fcbName(fcb);
+    size_t slot = fcb[fcbHandle] | (fcb[fcbHandle + 1] << 8);
+    if (slot == 0 || slot > files.size() || !files[slot - 1].file || files[slot - 1].name != name) {
+        slot = 0;
+        for (size_t i = 0; i < files.size() && !slot; i++) {
+            if (files[i].file && files[i].name == name)
+                slot = i + 1;
+        }
+    }
+
+    if (!slot && open) {
+        std::vector<std::string> found = findFiles(fcb);
+        if (found.empty())
+            return nullptr;
+
+        std::string path = hostPath(found[0]);
+        FILE* file = fopen(path.c_str(), "r+b");
+        if (!file)
+            file = fopen(path.c_str(), "rb");
+        if (!file)
+            return nullptr;
+
+        auto unused = std::find_if(files.begin(), files.end(), [](const OpenFile& x) { return !x.file; });
+        if (unused == files.end())
+            unused = files.insert(files.end(), OpenFile {});
+        *unused = { name, path, file };
+        slot = unused - files.begin() + 1;
+    }
+    if (!slot)
+        return nullptr;
+
+    putWord(fcb + fcbHandle, static_cast<uint16_t>(slot));
+    return &files[slot - 1];
+}
+
+void CpmMachine::closeFile(uint8_t* fcb) {
+    OpenFile* file = fileOf(fcb, false);
+    if (!file)
+        return;
+    fclose(file->file);
+    file->file = nullptr;
+}
+
+uint8_t CpmMachine::openFile(uint16_t address) {
+    uint8_t* fcb = &memory[address];
+    OpenFile* file = fileOf(fcb, true);
+    if (!file)
+        return 0xFF;
+    fcb[fcbRecordCount] = extentRecords(fcb, file->path);
+    return 0;
+}
+
+uint8_t CpmMachine::makeFile(uint16_t address) {
+    uint8_t* fcb = &memory[address];
+    closeFile(fcb);
+    if (!validName(fcb, false))
+        return 0xFF;
+
+    /* An existing file of another case is replaced under its own name */
+    std::string name = fcbName(fcb);
+    std::vector<std::string> found = findFiles(fcb);
+    std::string path = hostPath(found.empty() ? name : found[0]);
+    if (path.empty())
+        return 0xFF;
+    FILE* file = fopen(path.c_str(), "w+b");
+    if (!file)
+        return 0xFF;
+
+    auto unused = std::find_if(files.begin(), files.end(), [](const OpenFile& x) { return !x.file; });
+    if (unused == files.end())
+        unused = files.insert(files.end(), OpenFile {});
+    *unused = { name, path, file };
+    putWord(fcb + fcbHandle, static_cast<uint16_t>(unused - files.begin() + 1));
+    fcb[fcbRecordCount] = 0;
+    return 0;
+}
+
+/* One directory entry per file at the start of the DMA buffer, its last extent with the records
+ * in it, which is what programs sizing files from the directory add up */
+uint8_t CpmMachine::search(bool first) {
+    if (first) {
+        searchResults = findFiles(&memory[(state.d << 8) | state.e]);
+        searchPosition = 0;
+    }
+    if (searchPosition >= searchResults.size())
+        return 0xFF;
+
+    const std::string& name = searchResults[searchPosition++];
+    uint8_t entry[32] = {};
+    char padded[11];
+    shortName(name, padded);
+    entry[0] = user;
+    memcpy(entry + 1, padded, 11);
+
+    std::error_code error;
+    uint64_t size = std::filesystem::file_size(hostPath(name), error);
+    uint64_t records = error ? 0 : (size + recordSize - 1) / recordSize;
+    uint64_t lastExtent = records ? (records - 1) / 128 : 0;
+    entry[fcbExtent] = lastExtent & 0x1F;
+    entry[fcbModule] = static_cast<uint8_t>(lastExtent >> 5);
+    entry[fcbRecordCount] = static_cast<uint8_t>(records - lastExtent * 128);
+    memset(entry + 16, records ? 1 : 0, 16);
+
+    for (int i = 0; i < 32; i++)
+        memory[static_cast<uint16_t>(dma + i)] = entry[i];
+    return 0;
+}
+
+uint8_t CpmMachine::deleteFiles(uint16_t address) {
+    uint8_t* fcb = &memory[address];
+    std::vector<std::string> found = findFiles(fcb);
+    for (const std::string& name : found) {
+        for (OpenFile& file : files) {
+            if (file.file && file.path == hostPath(name)) {
+                fclose(file.file);
+                file.file = nullptr;
+            }
+        }
+        std::error_code error;
+        std::filesystem::remove(hostPath(name), error);
+    }
+    return found.empty() ? 0xFF : 0;
+}
+
+/* The new name is in the second half of the FCB */
+uint8_t CpmMachine::renameFile(uint16_t address) {
+    uint8_t* fcb = &memory[address];
+    std::vector<std::string> found = findFiles(fcb);
+    if (found.empty() || !validName(fcb + 16, false))
+        return 0xFF;
+    std::string from = hostPath(found[0]);
+    std::string to = hostPath(fcbName(fcb + 16));
+    if (from.empty() || to.empty())
+        return 0xFF;
+
+    closeFile(fcb);
+    std::error_code error;
+    std::filesystem::rename(from, to, error);
+    return error ? 0xFF : 0;
+}
+
+/* Read or write one record at the DMA address. Sequential transfers use and advance the current
+ * record of the FCB, random ones the random record, which becomes the current one */
+uint8_t CpmMachine::transfer(uint16_t address, bool write, bool random) {
+    uint8_t* fcb = &memory[address];
+    if (random) {
+        if (fcb[fcbRandom + 2])
+            return 6;
+        setCurrentRecord(fcb, fcb[fcbRandom] | (fcb[fcbRandom + 1] << 8));
+    }
+
+    OpenFile* file = fileOf(fcb, true);
+    if (!file)
+        return write ? 2 : 1;
+
+    uint32_t record = currentRecord(fcb);
+    uint8_t buffer[recordSize];
+    fseek(file->file, static_cast<long>(record) * recordSize, SEEK_SET);
+    if (write) {
+        for (int i = 0; i < recordSize; i++)
+            buffer[i] = memory[static_cast<uint16_t>(dma + i)];
+        if (fwrite(buffer, 1, recordSize, file->file) != recordSize)
+            return 2;
+        fflush(file->file);
+    }
+    else {
+        size_t size = fread(buffer, 1, recordSize, file->file);
+        if (size == 0)
+            return 1;
+        memset(buffer + size, 0x1A, recordSize - size);
+        for (int i = 0; i < recordSize; i++)
+            memory[static_cast<uint16_t>(dma + i)] = buffer[i];
+    }
+
+    if (!random)
+        setCurrentRecord(fcb, record + 1);
+    fcb[fcbRecordCount] = extentRecords(fcb, file->path);
+    return 0;
+}
+
+/* Records of the file into the random record field */
+void CpmMachine::fileSize(uint16_t address) {
+    uint8_t* fcb = &memory[address];
+    std::vector<std::string> found = findFiles(fcb);
+    std::error_code error;
+    uint64_t size = found.empty() ? 0 : std::filesystem::file_size(hostPath(found[0]), error);
+    uint64_t records = error ? 0 : (size + recordSize - 1) / recordSize;
+    fcb[fcbRandom] = records & 0xFF;
+    fcb[fcbRandom + 1] = (records >> 8) & 0xFF;
+    fcb[fcbRandom + 2] = (records >> 16) & 0xFF;
+}
+
+void CpmMachine::setRandomRecord(uint16_t address) {
+    uint8_t* fcb = &memory[address];
+    uint32_t record = currentRecord(fcb);
+    fcb[fcbRandom] = record & 0xFF;
+    fcb[fcbRandom + 1] = (record >> 8) & 0xFF;
+    fcb[fcbRandom + 2] = (record >> 16) & 0xFF;
+}
@@ -0,0 +1,121 @@
+#ifndef CPMMACHINE_H
+#define CPMMACHINE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Emulator8080.h"
+
+/* A CP/M 2.2 system for running .COM programs, with BDOS and BIOS emulated on the host.
+ *
+ * The BDOS entry and the BIOS jump table lead to OUT instructions the machine traps by their
+ * address, so the calls cost one port write and the program runs at full speed in between.
+ * Console calls go to an output buffer and read from an input text or file. File calls work on the
+ * files of a host directory, drive A: and every other drive alike, with 8.3 names matched without
+ * regard to case. A program ends with a warm boot, through a jump to 0, BDOS function 0 or a return
+ * from its first stack frame, or with a HLT. The CPU is the core built for the model given, the 8080,
+ * the 8085 or the Z80 */
+class CpmMachine
+{
+public:
+    static constexpr uint16_t tpaStart = 0x0100;
+    static constexpr uint16_t bdosAddress = 0xFE00;
+    static constexpr uint16_t biosAddress = 0xFF00;
+
+    explicit CpmMachine(CpuModel model = CpuModel::Intel8080);
+    CpmMachine(const CpmMachine&) = delete;
+    CpmMachine& operator=(const CpmMachine&) = delete;
+    ~CpmMachine();
+
+    bool Load(const std::string& path, const std::string& arguments = "");
+    void SetDirectory(const std::string& path);
+    void SetInput(const std::string& text);
+    void SetInputFile(FILE* file);
+    void SetEcho(FILE* file);
+
+    bool Run(uint64_t maxCycles = UINT64_MAX);
+    bool Finished() const;
+    uint64_t Cycles() const;
+    const std::string& Output() const;
+
+    CpuState State() const;
+    uint8_t* Memory();
+
+private:
+    /* The calls the machine makes on its CPU, whichever core runs it */
+    class Processor
+    {
+    public:
+        virtual ~Processor() = default;
+        virtual StopReason RunUntil(uint64_t cycle) = 0;
+        virtual uint64_t Cycles() const = 0;
+        virtual void SetCycles(uint64_t count) = 0;
+        virtual uint16_t ProgramCounter() const = 0;
+        virtual CpuState State() const = 0;
+        virtual void SetState(const CpuState& state) = 0;
+    };
+
+    template <class Policies>
+    class ProcessorOf;
+
+    struct OpenFile
+    {
+        std::string name;
+        std::string path;
+        FILE* file;
+    };
+
+    static void portOut(void* context, uint8_t port, uint8_t value);
+
+    void bdos();
+    void bios(int function);
+    void finish();
+
+    bool consoleReady();
+    uint8_t consoleRead();
+    void consoleWrite(uint8_t character);
+    void readLine(uint16_t buffer);
+
+    static std::string fcbName(const uint8_t* fcb);
+    static bool matches(const uint8_t* fcb, const std::string& name);
+    std::vector<std::string> findFiles(const uint8_t* fcb) const;
+    std::string hostPath(const std::string& name) const;
+    OpenFile* fileOf(uint8_t* fcb, bool open);
+    void closeFile(uint8_t* fcb);
+
+    uint8_t openFile(uint16_t fcb);
+    uint8_t makeFile(uint16_t fcb);
+    uint8_t search(bool first);
+    uint8_t deleteFiles(uint16_t fcb);
+    uint8_t renameFile(uint16_t fcb);
+    uint8_t transfer(uint16_t fcb, bool write, bool random);
+    void fileSize(uint16_t fcb);
+    void setRandomRecord(uint16_t fcb);
+
+private:
+    std::vector<uint8_t> memory;
+    std::unique_ptr<Processor> cpu;
+    CpuState state;
+
+    std::string directory;
+    std::string input;
+    size_t inputPosition;
+    FILE* inputFile;
+    FILE* echo;
+    std::string output;
+
+    uint16_t dma;
+    uint8_t disk;
+    uint8_t user;
+    std::vector<OpenFile> files;
+    std::vector<std::string> searchResults;
+    size_t searchPosition;
+
+    bool finished;
+    uint64_t exitCycles;
+};
+
+#endif
@@ -0,0 +1,194 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "CpmMachine.h"
+#include "ThreadPool.h"
+
+/* One program of a batch and what became of it */
+struct Job
+{
+    std::string program;
+    std::string arguments;
+
+    bool loaded = false;
+    bool finished = false;
+    uint64_t cycles = 0;
+    double seconds = 0;
+    std::string output;
+};
+
+struct Batch
+{
+    std::vector<Job> jobs;
+    std::string directory;
+    std::string input;
+    uint64_t maxCycles = UINT64_MAX;
+    CpuModel model = CpuModel::Intel8080;
+};
+
+/* ThreadPool task running one job on a machine of its own, its console kept for printing in order */
+static void runJob(void* context, size_t index) {
+    auto* batch = static_cast<Batch*>(context);
+    Job& job = batch->jobs[index];
+
+    auto machine = std::make_unique<CpmMachine>(batch->model);
+    machine->SetDirectory(batch->directory);
+    machine->SetInput(batch->input);
+    job.loaded = machine->Load(job.program, job.arguments);
+    if (!job.loaded)
+        return;
+
+    auto begin = std::chrono::steady_clock::now();
+    job.finished = machine->Run(batch->maxCycles);
+    job.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    job.cycles = machine->Cycles();
+    job.output = machine->Output();
+}
+
+static void printResult(const Job& job) {
+    if (!job.loaded)
+        printf("*** %s: not found\n", job.program.c_str());
+    else {
+        printf("*** %s: %s, %llu cycles in %.3f s\n", job.program.c_str(),
+               job.finished ? "finished" : "cycle limit reached", static_cast<unsigned long long>(job.cycles),
+               job.seconds);
+    }
+}
+
+static bool parseModel(const std::string& name, CpuModel& model) {
+    if (name == "8080")
+        model = CpuModel::Intel8080;
+    else if (name == "8085")
+        model = CpuModel::Intel8085;
+    else if (name == "z80")
+        model = CpuModel::Z80;
+    else
+        return false;
+    return true;
+}
+
+/* A batch file has one program per line with its arguments, # starting a comment */
+static bool readBatch(const std::string& path, std::vector<Job>& jobs) {
+    std::ifstream file(path);
+    if (!file)
+        return false;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream words(line);
+        Job job;
+        if (!(words >> job.program))
+            continue;
+        std::getline(words >> std::ws, job.arguments);
+        while (!job.arguments.empty() && (job.arguments.back() == '\r' || job.arguments.back() == ' '))
+            job.arguments.pop_back();
+        jobs.push_back(job);
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    Batch batch;
+    batch.directory = ".";
+    std::string inputPath;
+    std::string batchPath;
+    size_t threads = 1;
+    std::vector<std::string> command;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (!command.empty())
+            command.push_back(arg);
+        else if (arg == "--dir" && i + 1 < argc)
+            batch.directory = argv[++i];
+        else if (arg == "--input" && i + 1 < argc)
+            inputPath = argv[++i];
+        else if (arg == "--max-cycles" && i + 1 < argc)
+            batch.maxCycles = std::stoull(argv[++i]);
+        else if (arg == "--batch" && i + 1 < argc)
+            batchPath = argv[++i];
+        else if (arg == "--jobs" && i + 1 < argc)
+            threads = std::stoul(argv[++i]);
+        else if (arg == "--cpu" && i + 1 < argc) {
+            if (!parseModel(argv[++i], batch.model)) {
+                fprintf(stderr, "Error: unknown CPU %s, available: 8080, 8085, z80\n", argv[i]);
+                return 1;
+            }
+        }
+        else
+            command.push_back(arg);
+    }
+    if (command.empty() == batchPath.empty()) {
+        fprintf(stderr, "Usage: %s [--cpu 8080|8085|z80] [--dir DIR] [--input FILE] [--max-cycles N] "
+                        "<program.com> [arguments...]\n"
+                        "       %s [--cpu 8080|8085|z80] [--dir DIR] [--input FILE] [--max-cycles N] "
+                        "--batch FILE [--jobs N]\n",
+                argv[0], argv[0]);
+        return 1;
+    }
+
+    if (!inputPath.empty()) {
+        std::ifstream file(inputPath, std::ios::binary);
+        if (!file) {
+            fprintf(stderr, "Error: cannot read %s\n", inputPath.c_str());
+            return 1;
+        }
+        batch.input.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    /* A single program talks to the terminal, unless given an input file */
+    if (!command.empty()) {
+        CpmMachine machine(batch.model);
+        machine.SetDirectory(batch.directory);
+        if (inputPath.empty())
+            machine.SetInputFile(stdin);
+        else
+            machine.SetInput(batch.input);
+        machine.SetEcho(stdout);
+
+        std::string arguments;
+        for (size_t i = 1; i < command.size(); i++)
+            arguments += (i > 1 ? " " : "") + command[i];
+        if (!machine.Load(command[0], arguments)) {
+            fprintf(stderr, "Error: file not found %s\n", command[0].c_str());
+            return 1;
+        }
+        bool finished = machine.Run(batch.maxCycles);
+        fflush(stdout);
+        fprintf(stderr, "\n%s, %llu cycles\n", finished ? "Finished" : "Cycle limit reached",
+                static_cast<unsigned long long>(machine.Cycles()));
+        return finished ? 0 : 1;
+    }
+
+    if (!readBatch(batchPath, batch.jobs)) {
+        fprintf(stderr, "Error: cannot read %s\n", batchPath.c_str());
+        return 1;
+    }
+
+    /* The jobs share the directory, jobs writing the same files should not run together */
+    ThreadPool pool(threads);
+    auto begin = std::chrono::steady_clock::now();
+    pool.Run(batch.jobs.size(), runJob, &batch);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    int failures = 0;
+    uint64_t cycles = 0;
+    for (const Job& job : batch.jobs) {
+        fputs(job.output.c_str(), stdout);
+        if (!job.output.empty() && job.output.back() != '\n')
+            putchar('\n');
+        printResult(job);
+        cycles += job.cycles;
+        failures += !job.finished;
+    }
+    printf("*** %zu programs, %d not finished, %llu cycles in %.3f s on %zu threads\n", batch.jobs.size(), failures,
+           static_cast<unsigned long long>(cycles), seconds, pool.Threads());
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,232 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Disassembler8080.h"
+#include "Emulator8080.h"
+#include "Reference8080.h"
+
+/* CP/M programs are loaded at the start of the TPA, BDOS is entered through 0x0005 */
+static constexpr uint16_t tpaStart = 0x0100;
+static constexpr uint16_t bdosEntry = 0x0005;
+static constexpr uint16_t memoryTop = 0xFE00;
+
+/* Memory is compared every this many instructions in the differential mode */
+static constexpr uint64_t memoryCheckInterval = 1 << 16;
+
+/* Common interface of the engines compared by the harness */
+class Engine
+{
+public:
+    virtual ~Engine() = default;
+    virtual void Step() = 0;
+    virtual CpuState State() const = 0;
+    virtual uint64_t Cycles() const = 0;
+    virtual const uint8_t* Memory() const = 0;
+};
+
+template <class Cpu>
+class CpuEngine : public Engine
+{
+public:
+    explicit CpuEngine(const std::vector<uint8_t>& image) : memory(image), cpu(memory.data(), tpaStart)
+    { }
+
+    void Step() override { step(cpu); }
+    CpuState State() const override { return cpu.State(); }
+    uint64_t Cycles() const override { return cpu.Cycles(); }
+    const uint8_t* Memory() const override { return memory.data(); }
+
+private:
+    template <class Policies>
+    static void step(Emulator8080<Policies>& emulator) { emulator.Emulate(); }
+    static void step(Reference8080& reference) { reference.Step(); }
+
+private:
+    std::vector<uint8_t> memory;
+    Cpu cpu;
+};
+
+static std::unique_ptr<Engine> makeEngine(const std::string& name, const std::vector<uint8_t>& image) {
+    if (name == "switch")
+        return std::make_unique<CpuEngine<Emulator8080<>>>(image);
+    if (name == "8085")
+        return std::make_unique<CpuEngine<Emulator8080<Intel8085Policies>>>(image);
+    if (name == "z80")
+        return std::make_unique<CpuEngine<Emulator8080<Z80Policies>>>(image);
+    if (name == "reference")
+        return std::make_unique<CpuEngine<Reference8080>>(image);
+    return nullptr;
+}
+
+/* Memory image of a CP/M program: a RET stands in for BDOS, the word at 0x0006 holds the top of the TPA */
+static bool loadProgram(const std::string& path, std::vector<uint8_t>& image) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file)
+        return false;
+
+    image.assign(0x10000, 0);
+    fread(&image[tpaStart], 1, 0x10000 - tpaStart, file);
+    fclose(file);
+
+    image[bdosEntry] = 0xC9;
+    image[bdosEntry + 1] = memoryTop & 0xFF;
+    image[bdosEntry + 2] = memoryTop >> 8;
+    return true;
+}
+
+/* Console calls of BDOS: 2 writes the character in E, 9 writes the string at DE up to a '$' */
+static void bdosCall(const Engine& engine, std::string& console) {
+    CpuState state = engine.State();
+    const uint8_t* memory = engine.Memory();
+    size_t printed = console.size();
+
+    if (state.c == 2)
+        console += static_cast<char>(state.e);
+    else if (state.c == 9) {
+        uint16_t start = (state.d << 8) | state.e;
+        for (uint32_t count = 0; count < 0x10000 && memory[(start + count) & 0xFFFF] != '$'; count++)
+            console += static_cast<char>(memory[(start + count) & 0xFFFF]);
+    }
+    fputs(console.c_str() + printed, stdout);
+}
+
+static uint8_t packFlags(const ConditionCodes& cc) {
+    return (cc.s << 7) | (cc.z << 6) | (cc.ac << 4) | (cc.p << 2) | 0x02 | cc.cy;
+}
+
+static bool sameState(const CpuState& x, const CpuState& y) {
+    return x.a == y.a && x.b == y.b && x.c == y.c && x.d == y.d && x.e == y.e && x.h == y.h &&
+           x.l == y.l && x.sp == y.sp && x.pc == y.pc && packFlags(x.cc) == packFlags(y.cc) &&
+           x.halted == y.halted;
+}
+
+static void printState(const char* name, const CpuState& state, uint64_t cycles) {
+    printf("  %-10s A=%02X B=%02X C=%02X D=%02X E=%02X H=%02X L=%02X SP=%04X PC=%04X "
+           "S=%d Z=%d AC=%d P=%d CY=%d cycles=%llu\n", name, state.a, state.b, state.c, state.d, state.e,
+           state.h, state.l, state.sp, state.pc, state.cc.s, state.cc.z, state.cc.ac, state.cc.p, state.cc.cy,
+           static_cast<unsigned long long>(cycles));
+}
+
+/* Run the program on the engines in lockstep, until it jumps back to CP/M through 0x0000.
+ * Returns false on the first instruction the engines disagree on */
+static bool runProgram(const std::vector<uint8_t>& image, const std::vector<std::string>& engineNames,
+                       uint64_t maxInstructions, std::string& console, uint64_t& instructions) {
+    std::vector<std::unique_ptr<Engine>> engines;
+    for (const std::string& name : engineNames)
+        engines.push_back(makeEngine(name, image));
+    Engine& primary = *engines[0];
+
+    instructions = 0;
+    while (instructions < maxInstructions) {
+        CpuState before = primary.State();
+        uint64_t cyclesBefore = primary.Cycles();
+        if (before.pc == 0x0000)
+            return true;
+        if (before.pc == bdosEntry)
+            bdosCall(primary, console);
+
+        for (auto& engine : engines)
+            engine->Step();
+        ++instructions;
+
+        CpuState after = primary.State();
+        for (size_t i = 1; i < engines.size(); i++) {
+            bool memoryDiffers = instructions % memoryCheckInterval == 0 &&
+                std::memcmp(primary.Memory(), engines[i]->Memory(), 0x10000) != 0;
+
+            if (sameState(after, engines[i]->State()) && primary.Cycles() == engines[i]->Cycles() && !memoryDiffers)
+                continue;
+
+            printf("\nEngines diverged after %llu instructions%s at:\n  ",
+                   static_cast<unsigned long long>(instructions), memoryDiffers ? " (memory)" : "");
+            disassembler(const_cast<uint8_t*>(engines[i]->Memory()), before.pc);
+            printState("before", before, cyclesBefore);
+            printState(engineNames[0].c_str(), after, primary.Cycles());
+            printState(engineNames[i].c_str(), engines[i]->State(), engines[i]->Cycles());
+            return false;
+        }
+
+        /* Without interrupts nothing wakes the CPU again */
+        if (after.halted && !after.intEnable) {
+            printf("\nHalted at %04X\n", static_cast<unsigned>(after.pc - 1));
+            return false;
+        }
+    }
+    printf("\nInstruction limit reached\n");
+    return false;
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> engineNames = { "switch" };
+    std::vector<std::string> programs;
+    uint64_t maxInstructions = UINT64_MAX;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--diff" && i + 1 < argc) {
+            /* Comma separated list of the engines, the first one drives BDOS */
+            engineNames.clear();
+            std::string list = argv[++i];
+            for (size_t start = 0, end; start <= list.size(); start = end + 1) {
+                end = list.find(',', start);
+                if (end == std::string::npos)
+                    end = list.size();
+                engineNames.push_back(list.substr(start, end - start));
+            }
+        }
+        else if (arg == "--cpu" && i + 1 < argc) {
+            /* The core built for the model, the 8080 one being the switch engine */
+            std::string model = argv[++i];
+            engineNames = { model == "8080" ? "switch" : model };
+        }
+        else if (arg == "--max-instructions" && i + 1 < argc)
+            maxInstructions = std::stoull(argv[++i]);
+        else
+            programs.push_back(arg);
+    }
+    for (const std::string& name : engineNames) {
+        if (!makeEngine(name, std::vector<uint8_t>(0x10000))) {
+            fprintf(stderr, "Error: unknown engine %s, available: switch, 8085, z80, reference\n", name.c_str());
+            return 1;
+        }
+    }
+    if (programs.empty()) {
+        fprintf(stderr, "Usage: %s [--cpu 8080|8085|z80] [--diff switch,reference] [--max-instructions N] <program.com>...\n",
+                argv[0]);
+        return 1;
+    }
+
+    int failures = 0;
+    for (const std::string& path : programs) {
+        std::vector<uint8_t> image;
+        if (!loadProgram(path, image)) {
+            fprintf(stderr, "Error: file not found %s\n", path.c_str());
+            ++failures;
+            continue;
+        }
+
+        printf("*** %s\n", path.c_str());
+        std::string console;
+        uint64_t instructions = 0;
+
+        auto begin = std::chrono::steady_clock::now();
+        bool completed = runProgram(image, engineNames, maxInstructions, console, instructions);
+        auto end = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(end - begin).count();
+
+        /* The exercisers report failed tests in their output */
+        bool passed = completed && console.find("ERROR") == std::string::npos &&
+                      console.find("FAILED") == std::string::npos;
+        if (!passed)
+            ++failures;
+
+        printf("\n*** %s: %s, %llu instructions in %.2f s\n", path.c_str(), passed ? "passed" : "FAILED",
+               static_cast<unsigned long long>(instructions), seconds);
+    }
+    return failures ? 1 : 0;
+}
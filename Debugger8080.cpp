@@ -0,0 +1,69 @@
+#include "Debugger8080.h"
+
+#include <algorithm>
+#include <iterator>
+
+
+Debugger8080::Debugger8080() : breakpoints(), reads(), writes(), portsIn(), portsOut(),
+    hitHandler(nullptr), hitContext(nullptr)
+{ }
+
+void Debugger8080::assign(uint64_t* bits, uint32_t index, bool enabled) {
+    uint64_t mask = uint64_t(1) << (index & 63);
+    if (enabled)
+        bits[index >> 6] |= mask;
+    else
+        bits[index >> 6] &= ~mask;
+}
+
+void Debugger8080::SetBreakpoint(uint16_t address, bool enabled) {
+    assign(breakpoints, address, enabled);
+}
+
+void Debugger8080::SetReadWatchpoint(uint16_t address, bool enabled) {
+    assign(reads, address, enabled);
+}
+
+void Debugger8080::SetWriteWatchpoint(uint16_t address, bool enabled) {
+    assign(writes, address, enabled);
+}
+
+void Debugger8080::SetPortInWatchpoint(uint8_t port, bool enabled) {
+    assign(portsIn, port, enabled);
+}
+
+void Debugger8080::SetPortOutWatchpoint(uint8_t port, bool enabled) {
+    assign(portsOut, port, enabled);
+}
+
+void Debugger8080::ClearAll() {
+    std::fill(std::begin(breakpoints), std::end(breakpoints), 0);
+    std::fill(std::begin(reads), std::end(reads), 0);
+    std::fill(std::begin(writes), std::end(writes), 0);
+    std::fill(std::begin(portsIn), std::end(portsIn), 0);
+    std::fill(std::begin(portsOut), std::end(portsOut), 0);
+}
+
+void Debugger8080::SetHitHandler(HitHandler handler, void* context) {
+    hitHandler = handler;
+    hitContext = context;
+}
+
+/* Slow path taken by the CPU once a set bit matched. Returns whether the run loop stops */
+bool Debugger8080::Trigger(Event event, uint16_t pc, uint16_t address, uint8_t value) {
+    Hit hit;
+    hit.event = event;
+    hit.pc = pc;
+    hit.address = address;
+    hit.value = value;
+
+    if (hitHandler && !hitHandler(hitContext, hit))
+        return false;
+
+    lastHit = hit;
+    return true;
+}
+
+const Debugger8080::Hit& Debugger8080::LastHit() const {
+    return lastHit;
+}
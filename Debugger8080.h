@@ -0,0 +1,92 @@
+#ifndef DEBUGGER8080_H
+#define DEBUGGER8080_H
+
+#include <cstdint>
+
+/* Execution breakpoints, memory read/write watchpoints and port watchpoints kept as bitmaps,
+ * so the run loop tests a single bit per check and only calls out when the bit is set */
+class Debugger8080
+{
+public:
+    enum class Event
+    {
+        None,
+        Breakpoint,
+        MemoryRead,
+        MemoryWrite,
+        PortIn,
+        PortOut
+    };
+
+    struct Hit
+    {
+        Event event = Event::None;
+        uint16_t pc = 0;
+        uint16_t address = 0;
+        uint8_t value = 0;
+    };
+
+    /* Decides whether a hit stops the run loop, without one every hit stops it */
+    using HitHandler = bool (*)(void* context, const Hit& hit);
+
+    Debugger8080();
+
+    void SetBreakpoint(uint16_t address, bool enabled = true);
+    void SetReadWatchpoint(uint16_t address, bool enabled = true);
+    void SetWriteWatchpoint(uint16_t address, bool enabled = true);
+    void SetPortInWatchpoint(uint8_t port, bool enabled = true);
+    void SetPortOutWatchpoint(uint8_t port, bool enabled = true);
+    void ClearAll();
+
+    void SetHitHandler(HitHandler handler, void* context);
+
+    bool IsBreakpoint(uint16_t address) const;
+    bool IsReadWatched(uint16_t address) const;
+    bool IsWriteWatched(uint16_t address) const;
+    bool IsPortInWatched(uint8_t port) const;
+    bool IsPortOutWatched(uint8_t port) const;
+
+    bool Trigger(Event event, uint16_t pc, uint16_t address, uint8_t value);
+    const Hit& LastHit() const;
+
+private:
+    static bool test(const uint64_t* bits, uint32_t index);
+    static void assign(uint64_t* bits, uint32_t index, bool enabled);
+
+private:
+    uint64_t breakpoints[0x10000 / 64];
+    uint64_t reads[0x10000 / 64];
+    uint64_t writes[0x10000 / 64];
+    uint64_t portsIn[256 / 64];
+    uint64_t portsOut[256 / 64];
+
+    HitHandler hitHandler;
+    void* hitContext;
+    Hit lastHit;
+};
+
+inline bool Debugger8080::test(const uint64_t* bits, uint32_t index) {
+    return (bits[index >> 6] >> (index & 63)) & 1;
+}
+
+inline bool Debugger8080::IsBreakpoint(uint16_t address) const {
+    return test(breakpoints, address);
+}
+
+inline bool Debugger8080::IsReadWatched(uint16_t address) const {
+    return test(reads, address);
+}
+
+inline bool Debugger8080::IsWriteWatched(uint16_t address) const {
+    return test(writes, address);
+}
+
+inline bool Debugger8080::IsPortInWatched(uint8_t port) const {
+    return test(portsIn, port);
+}
+
+inline bool Debugger8080::IsPortOutWatched(uint8_t port) const {
+    return test(portsOut, port);
+}
+
+#endif
@@ -3,11 +3,18 @@
 
 #include <cstdio>
 
-int disassembler(unsigned char* buffer, int pc)
+inline int disassembler(unsigned char* buffer, int pc, FILE* out = stdout)
 {
+    /* Operands past 0xFFFF are read from 0x0000, where the CPU fetches them */
+    unsigned char wrapped[3];
     unsigned char* code = &buffer[pc];
+    if (pc > 0xFFFD) {
+        for (int i = 0; i < 3; i++)
+            wrapped[i] = buffer[(pc + i) & 0xFFFF];
+        code = wrapped;
+    }
     int opBytes = 1;
-    printf("0x%04x\t", pc);
+    fprintf(out, "0x%04x\t", pc);
 
     switch (*code) {
         case 0x00:
@@ -18,808 +25,808 @@ int disassembler(unsigned char* buffer, int pc)
         case 0x18:
         case 0x28:
         case 0x38:
-            printf("NOP");
+            fprintf(out, "NOP");
             break;
 
         case 0x01:
-            printf("LXI\tB, #$0x%02x%02x", code[2], code[1]);
+            fprintf(out, "LXI\tB, #$0x%02x%02x", code[2], code[1]);
             opBytes = 3;
             break;
         case 0x02:
-            printf("STAX\tB");
+            fprintf(out, "STAX\tB");
             break;
         case 0x03:
-            printf("INX\tB");
+            fprintf(out, "INX\tB");
             break;
         case 0x04:
-            printf("INR\tB");
+            fprintf(out, "INR\tB");
             break;
         case 0x05:
-            printf("DCR\tB");
+            fprintf(out, "DCR\tB");
             break;
         case 0x06:
-            printf("MVI\tB, #$0x%02x", code[1]);
+            fprintf(out, "MVI\tB, #$0x%02x", code[1]);
             opBytes = 2;
             break;
         case 0x07:
-            printf("RLC");
+            fprintf(out, "RLC");
             break;
         case 0x09:
-            printf("DAD\tB");
+            fprintf(out, "DAD\tB");
             break;
         case 0x0A:
-            printf("LDAX\tB");
+            fprintf(out, "LDAX\tB");
             break;
         case 0x0B:
-            printf("DCX\tB");
+            fprintf(out, "DCX\tB");
             break;
         case 0x0C:
-            printf("INR\tT");
+            fprintf(out, "INR\tT");
             break;
         case 0x0D:
-            printf("DCR\tC");
+            fprintf(out, "DCR\tC");
             break;
         case 0x0E:
-            printf("MVI\tC, #$0x%02x", code[1]);
+            fprintf(out, "MVI\tC, #$0x%02x", code[1]);
             opBytes = 2;
             break;
         case 0x0F:
-            printf("RRC");
+            fprintf(out, "RRC");
             break;
 
         case 0x11:
-            printf("LXI\tD, #$0x%02x%02x", code[2], code[1]);
+            fprintf(out, "LXI\tD, #$0x%02x%02x", code[2], code[1]);
             opBytes = 3;
             break;
         case 0x12:
-            printf("STAX\tD");
+            fprintf(out, "STAX\tD");
             break;
         case 0x13:
-            printf("INX\tD");
+            fprintf(out, "INX\tD");
             break;
         case 0x14:
-            printf("INR\tD");
+            fprintf(out, "INR\tD");
             break;
         case 0x15:
-            printf("DCR\tD");
+            fprintf(out, "DCR\tD");
             break;
         case 0x16:
-            printf("MVI\tB, #$0x%02x", code[1]);
+            fprintf(out, "MVI\tB, #$0x%02x", code[1]);
             opBytes = 2;
             break;
         case 0x17:
-            printf("RAL");
+            fprintf(out, "RAL");
             break;
         case 0x19:
-            printf("DAD\tD");
+            fprintf(out, "DAD\tD");
             break;
         case 0x1A:
-            printf("LDAX\tD");
+            fprintf(out, "LDAX\tD");
             break;
         case 0x1B:
-            printf("DCX\tD");
+            fprintf(out, "DCX\tD");
             break;
         case 0x1C:
-            printf("INR\tE");
+            fprintf(out, "INR\tE");
             break;
         case 0x1D:
-            printf("DCR\tE");
+            fprintf(out, "DCR\tE");
             break;
         case 0x1E:
-            printf("MVI\tE, #$0x%02x", code[1]);
+            fprintf(out, "MVI\tE, #$0x%02x", code[1]);
             opBytes = 2;
             break;
         case 0x1F:
-            printf("RAR");
+            fprintf(out, "RAR");
             break;
 
         case 0x21:
-            printf("LXI\tH, #$0x%02x%02x", code[2], code[1]);
+            fprintf(out, "LXI\tH, #$0x%02x%02x", code[2], code[1]);
             opBytes = 3;
             break;
         case 0x22:
-            printf("SHLD\t #$0x%02x%02x", code[2], code[1]);
+            fprintf(out, "SHLD\t #$0x%02x%02x", code[2], code[1]);
             opBytes = 3;
             break;
         case 0x23:
-            printf("INX\tH");
+            fprintf(out, "INX\tH");
             break;
         case 0x24:
-            printf("INR\tH");
+            fprintf(out, "INR\tH");
             break;
         case 0x25:
-            printf("DCR\tH");
+            fprintf(out, "DCR\tH");
             break;
         case 0x26:
-            printf("MVI\tH, #$0x%02x", code[1]);
+            fprintf(out, "MVI\tH, #$0x%02x", code[1]);
             opBytes = 2;
             break;
         case 0x27:
-            printf("DAA");
+            fprintf(out, "DAA");
             break;
         case 0x29:
-            printf("DAD\tH");
+            fprintf(out, "DAD\tH");
             break;
         case 0x2A:
-            printf("LHLD\t #$0x%02x%02x", code[2], code[1]);
+            fprintf(out, "LHLD\t #$0x%02x%02x", code[2], code[1]);
             opBytes = 3;
             break;
         case 0x2B:
-            printf("DCX\tH");
+            fprintf(out, "DCX\tH");
             break;
         case 0x2C:
-            printf("INR\tL");
+            fprintf(out, "INR\tL");
             break;
         case 0x2D:
-            printf("DCR\tL");
+            fprintf(out, "DCR\tL");
             break;
         case 0x2E:
-            printf("MVI\tL, #$0x%02x", code[1]);
+            fprintf(out, "MVI\tL, #$0x%02x", code[1]);
             opBytes = 2;
             break;
         case 0x2F:
-            printf("CMA");
+            fprintf(out, "CMA");
             break;
 
         case 0x31:
-            printf("LXI\tSP, #$0x%02x%02x", code[2], code[1]);
+            fprintf(out, "LXI\tSP, #$0x%02x%02x", code[2], code[1]);
             opBytes = 3;
             break;
         case 0x32:
-            printf("STA\t #$0x%02x%02x", code[2], code[1]);
+            fprintf(out, "STA\t #$0x%02x%02x", code[2], code[1]);
             opBytes = 3;
             break;
         case 0x33:
-            printf("INX\tSP");
+            fprintf(out, "INX\tSP");
             break;
         case 0x34:
-            printf("INR\tM");
+            fprintf(out, "INR\tM");
             break;
         case 0x35:
-            printf("DCR\tM");
+            fprintf(out, "DCR\tM");
             break;
         case 0x36:
-            printf("MVI\tM, #$0x%02x", code[1]);
+            fprintf(out, "MVI\tM, #$0x%02x", code[1]);
             opBytes = 2;
             break;
         case 0x37:
-            printf("STC");
+            fprintf(out, "STC");
             break;
         case 0x39:
-            printf("DAD\tSP");
+            fprintf(out, "DAD\tSP");
             break;
         case 0x3A:
-            printf("LDA\t #$0x%02x%02x", code[2], code[1]);
+            fprintf(out, "LDA\t #$0x%02x%02x", code[2], code[1]);
             opBytes = 3;
             break;
         case 0x3B:
-            printf("DCX\tSP");
+            fprintf(out, "DCX\tSP");
             break;
         case 0x3C:
-            printf("INR\tA");
+            fprintf(out, "INR\tA");
             break;
         case 0x3D:
-            printf("DCR\tA");
+            fprintf(out, "DCR\tA");
             break;
         case 0x3E:
-            printf("MVI\tA, #$0x%02x", code[1]);
+            fprintf(out, "MVI\tA, #$0x%02x", code[1]);
             opBytes = 2;
             break;
         case 0x3F:
-            printf("CMC");
+            fprintf(out, "CMC");
             break;
 
         case 0x40:
-            printf("MOV\tB, B");
+            fprintf(out, "MOV\tB, B");
             break;
         case 0x41:
-            printf("MOV\tB, C");
+            fprintf(out, "MOV\tB, C");
             break;
         case 0x42:
-            printf("MOV\tB, D");
+            fprintf(out, "MOV\tB, D");
             break;
         case 0x43:
-            printf("MOV\tB, E");
+            fprintf(out, "MOV\tB, E");
             break;
         case 0x44:
-            printf("MOV\tB, H");
+            fprintf(out, "MOV\tB, H");
             break;
         case 0x45:
-            printf("MOV\tB, L");
+            fprintf(out, "MOV\tB, L");
             break;
         case 0x46:
-            printf("MOV\tB, M");
+            fprintf(out, "MOV\tB, M");
             break;
         case 0x47:
-            printf("MOV\tB, A");
+            fprintf(out, "MOV\tB, A");
             break;
         case 0x48:
-            printf("MOV\tC, B");
+            fprintf(out, "MOV\tC, B");
             break;
         case 0x49:
-            printf("MOV\tC, C");
+            fprintf(out, "MOV\tC, C");
             break;
         case 0x4A:
-            printf("MOV\tC, D");
+            fprintf(out, "MOV\tC, D");
             break;
         case 0x4B:
-            printf("MOV\tC, E");
+            fprintf(out, "MOV\tC, E");
             break;
         case 0x4C:
-            printf("MOV\tC, H");
+            fprintf(out, "MOV\tC, H");
             break;
         case 0x4D:
-            printf("MOV\tC, L");
+            fprintf(out, "MOV\tC, L");
             break;
         case 0x4E:
-            printf("MOV\tC, M");
+            fprintf(out, "MOV\tC, M");
             break;
         case 0x4F:
-            printf("MOV\tC, A");
+            fprintf(out, "MOV\tC, A");
             break;
 
         case 0x50:
-            printf("MOV\tD, B");
+            fprintf(out, "MOV\tD, B");
             break;
         case 0x51:
-            printf("MOV\tD, C");
+            fprintf(out, "MOV\tD, C");
             break;
         case 0x52:
-            printf("MOV\tD, D");
+            fprintf(out, "MOV\tD, D");
             break;
         case 0x53:
-            printf("MOV\tD, E");
+            fprintf(out, "MOV\tD, E");
             break;
         case 0x54:
-            printf("MOV\tD, H");
+            fprintf(out, "MOV\tD, H");
             break;
         case 0x55:
-            printf("MOV\tD, L");
+            fprintf(out, "MOV\tD, L");
             break;
         case 0x56:
-            printf("MOV\tD, M");
+            fprintf(out, "MOV\tD, M");
             break;
         case 0x57:
-            printf("MOV\tD, A");
+            fprintf(out, "MOV\tD, A");
             break;
         case 0x58:
-            printf("MOV\tE, B");
+            fprintf(out, "MOV\tE, B");
             break;
         case 0x59:
-            printf("MOV\tE, C");
+            fprintf(out, "MOV\tE, C");
             break;
         case 0x5A:
-            printf("MOV\tE, D");
+            fprintf(out, "MOV\tE, D");
             break;
         case 0x5B:
-            printf("MOV\tE, E");
+            fprintf(out, "MOV\tE, E");
             break;
         case 0x5C:
-            printf("MOV\tE, H");
+            fprintf(out, "MOV\tE, H");
             break;
         case 0x5D:
-            printf("MOV\tE, L");
+            fprintf(out, "MOV\tE, L");
             break;
         case 0x5E:
-            printf("MOV\tE, M");
+            fprintf(out, "MOV\tE, M");
             break;
         case 0x5F:
-            printf("MOV\tE, A");
+            fprintf(out, "MOV\tE, A");
             break;
 
         case 0x60:
-            printf("MOV\tH, B");
+            fprintf(out, "MOV\tH, B");
             break;
         case 0x61:
-            printf("MOV\tH, C");
+            fprintf(out, "MOV\tH, C");
             break;
         case 0x62:
-            printf("MOV\tH, D");
+            fprintf(out, "MOV\tH, D");
             break;
         case 0x63:
-            printf("MOV\tH, E");
+            fprintf(out, "MOV\tH, E");
             break;
         case 0x64:
-            printf("MOV\tH, H");
+            fprintf(out, "MOV\tH, H");
             break;
         case 0x65:
-            printf("MOV\tH, L");
+            fprintf(out, "MOV\tH, L");
             break;
         case 0x66:
-            printf("MOV\tH, M");
+            fprintf(out, "MOV\tH, M");
             break;
         case 0x67:
-            printf("MOV\tH, A");
+            fprintf(out, "MOV\tH, A");
             break;
         case 0x68:
-            printf("MOV\tL, B");
+            fprintf(out, "MOV\tL, B");
             break;
         case 0x69:
-            printf("MOV\tL, C");
+            fprintf(out, "MOV\tL, C");
             break;
         case 0x6A:
-            printf("MOV\tL, D");
+            fprintf(out, "MOV\tL, D");
             break;
         case 0x6B:
-            printf("MOV\tL, E");
+            fprintf(out, "MOV\tL, E");
             break;
         case 0x6C:
-            printf("MOV\tL, H");
+            fprintf(out, "MOV\tL, H");
             break;
         case 0x6D:
-            printf("MOV\tL, L");
+            fprintf(out, "MOV\tL, L");
             break;
         case 0x6E:
-            printf("MOV\tL, M");
+            fprintf(out, "MOV\tL, M");
             break;
         case 0x6F:
-            printf("MOV\tL, A");
+            fprintf(out, "MOV\tL, A");
             break;
 
         case 0x70:
-            printf("MOV\tM, B");
+            fprintf(out, "MOV\tM, B");
             break;
         case 0x71:
-            printf("MOV\tM, C");
+            fprintf(out, "MOV\tM, C");
             break;
         case 0x72:
-            printf("MOV\tM, D");
+            fprintf(out, "MOV\tM, D");
             break;
         case 0x73:
-            printf("MOV\tM, E");
+            fprintf(out, "MOV\tM, E");
             break;
         case 0x74:
-            printf("MOV\tM, H");
+            fprintf(out, "MOV\tM, H");
             break;
         case 0x75:
-            printf("MOV\tM, L");
+            fprintf(out, "MOV\tM, L");
             break;
         case 0x76:
-            printf("HLT");
+            fprintf(out, "HLT");
             break;
         case 0x77:
-            printf("MOV\tM, A");
+            fprintf(out, "MOV\tM, A");
             break;
         case 0x78:
-            printf("MOV\tA, B");
+            fprintf(out, "MOV\tA, B");
             break;
         case 0x79:
-            printf("MOV\tA, C");
+            fprintf(out, "MOV\tA, C");
             break;
         case 0x7A:
-            printf("MOV\tA, D");
+            fprintf(out, "MOV\tA, D");
             break;
         case 0x7B:
-            printf("MOV\tA, E");
+            fprintf(out, "MOV\tA, E");
             break;
         case 0x7C:
-            printf("MOV\tA, H");
+            fprintf(out, "MOV\tA, H");
             break;
         case 0x7D:
-            printf("MOV\tA, L");
+            fprintf(out, "MOV\tA, L");
             break;
         case 0x7E:
-            printf("MOV\tA, M");
+            fprintf(out, "MOV\tA, M");
             break;
         case 0x7F:
-            printf("MOV\tA, A");
+            fprintf(out, "MOV\tA, A");
             break;
 
         case 0x80:
-            printf("ADD\tB");
+            fprintf(out, "ADD\tB");
             break;
         case 0x81:
-            printf("ADD\tC");
+            fprintf(out, "ADD\tC");
             break;
         case 0x82:
-            printf("ADD\tD");
+            fprintf(out, "ADD\tD");
             break;
         case 0x83:
-            printf("ADD\tE");
+            fprintf(out, "ADD\tE");
             break;
         case 0x84:
-            printf("ADD\tH");
+            fprintf(out, "ADD\tH");
             break;
         case 0x85:
-            printf("ADD\tL");
+            fprintf(out, "ADD\tL");
             break;
         case 0x86:
-            printf("ADD\tM");
+            fprintf(out, "ADD\tM");
             break;
         case 0x87:
-            printf("ADD\tA");
+            fprintf(out, "ADD\tA");
             break;
         case 0x88:
-            printf("ADC\tB");
+            fprintf(out, "ADC\tB");
             break;
         case 0x89:
-            printf("ADC\tC");
+            fprintf(out, "ADC\tC");
             break;
         case 0x8A:
-            printf("ADC\tD");
+            fprintf(out, "ADC\tD");
             break;
         case 0x8B:
-            printf("ADC\tE");
+            fprintf(out, "ADC\tE");
             break;
         case 0x8C:
-            printf("ADC\tH");
+            fprintf(out, "ADC\tH");
             break;
         case 0x8D:
-            printf("ADC\tL");
+            fprintf(out, "ADC\tL");
             break;
         case 0x8E:
-            printf("ADC\tM");
+            fprintf(out, "ADC\tM");
             break;
         case 0x8F:
-            printf("ADC\tA");
+            fprintf(out, "ADC\tA");
             break;
 
         case 0x90:
-            printf("SUB\tB");
+            fprintf(out, "SUB\tB");
             break;
         case 0x91:
-            printf("SUB\tC");
+            fprintf(out, "SUB\tC");
             break;
         case 0x92:
-            printf("SUB\tD");
+            fprintf(out, "SUB\tD");
             break;
         case 0x93:
-            printf("SUB\tE");
+            fprintf(out, "SUB\tE");
             break;
         case 0x94:
-            printf("SUB\tH");
+            fprintf(out, "SUB\tH");
             break;
         case 0x95:
-            printf("SUB\tL");
+            fprintf(out, "SUB\tL");
             break;
         case 0x96:
-            printf("SUB\tM");
+            fprintf(out, "SUB\tM");
             break;
         case 0x97:
-            printf("SUB\tA");
+            fprintf(out, "SUB\tA");
             break;
         case 0x98:
-            printf("SBB\tB");
+            fprintf(out, "SBB\tB");
             break;
         case 0x99:
-            printf("SBB\tC");
+            fprintf(out, "SBB\tC");
             break;
         case 0x9A:
-            printf("SBB\tD");
+            fprintf(out, "SBB\tD");
             break;
         case 0x9B:
-            printf("SBB\tE");
+            fprintf(out, "SBB\tE");
             break;
         case 0x9C:
-            printf("SBB\tH");
+            fprintf(out, "SBB\tH");
             break;
         case 0x9D:
-            printf("SBB\tL");
+            fprintf(out, "SBB\tL");
             break;
         case 0x9E:
-            printf("SBB\tM");
+            fprintf(out, "SBB\tM");
             break;
         case 0x9F:
-            printf("SBB\tA");
+            fprintf(out, "SBB\tA");
             break;
 
         case 0xA0:
-            printf("ANA\tB");
+            fprintf(out, "ANA\tB");
             break;
         case 0xA1:
-            printf("ANA\tC");
+            fprintf(out, "ANA\tC");
             break;
         case 0xA2:
-            printf("ANA\tD");
+            fprintf(out, "ANA\tD");
             break;
         case 0xA3:
-            printf("ANA\tE");
+            fprintf(out, "ANA\tE");
             break;
         case 0xA4:
-            printf("ANA\tH");
+            fprintf(out, "ANA\tH");
             break;
         case 0xA5:
-            printf("ANA\tL");
+            fprintf(out, "ANA\tL");
             break;
         case 0xA6:
-            printf("ANA\tM");
+            fprintf(out, "ANA\tM");
             break;
         case 0xA7:
-            printf("ANA\tA");
+            fprintf(out, "ANA\tA");
             break;
         case 0xA8:
-            printf("XRA\tB");
+            fprintf(out, "XRA\tB");
             break;
         case 0xA9:
-            printf("XRA\tC");
+            fprintf(out, "XRA\tC");
             break;
         case 0xAA:
-            printf("XRA\tD");
+            fprintf(out, "XRA\tD");
             break;
         case 0xAB:
-            printf("XRA\tE");
+            fprintf(out, "XRA\tE");
             break;
         case 0xAC:
-            printf("XRA\tH");
+            fprintf(out, "XRA\tH");
             break;
         case 0xAD:
-            printf("XRA\tL");
+            fprintf(out, "XRA\tL");
             break;
         case 0xAE:
-            printf("XRA\tM");
+            fprintf(out, "XRA\tM");
             break;
         case 0xAF:
-            printf("XRA\tA");
+            fprintf(out, "XRA\tA");
             break;
 
         case 0xB0:
-            printf("ORA\tB");
+            fprintf(out, "ORA\tB");
             break;
         case 0xB1:
-            printf("ORA\tC");
+            fprintf(out, "ORA\tC");
             break;
         case 0xB2:
-            printf("ORA\tD");
+            fprintf(out, "ORA\tD");
             break;
         case 0xB3:
-            printf("ORA\tE");
+            fprintf(out, "ORA\tE");
             break;
         case 0xB4:
-            printf("ORA\tH");
+            fprintf(out, "ORA\tH");
             break;
         case 0xB5:
-            printf("ORA\tL");
+            fprintf(out, "ORA\tL");
             break;
         case 0xB6:
-            printf("ORA\tM");
+            fprintf(out, "ORA\tM");
             break;
         case 0xB7:
-            printf("ORA\tA");
+            fprintf(out, "ORA\tA");
             break;
         case 0xB8:
-            printf("CMP\tB");
+            fprintf(out, "CMP\tB");
             break;
         case 0xB9:
-            printf("CMP\tC");
+            fprintf(out, "CMP\tC");
             break;
         case 0xBA:
-            printf("CMP\tD");
+            fprintf(out, "CMP\tD");
             break;
         case 0xBB:
-            printf("CMP\tE");
+            fprintf(out, "CMP\tE");
             break;
         case 0xBC:
-            printf("CMP\tH");
+            fprintf(out, "CMP\tH");
             break;
         case 0xBD:
-            printf("CMP\tL");
+            fprintf(out, "CMP\tL");
             break;
         case 0xBE:
-            printf("CMP\tM");
+            fprintf(out, "CMP\tM");
             break;
         case 0xBF:
-            printf("CMP\tA");
+            fprintf(out, "CMP\tA");
             break;
 
         case 0xC0:
-            printf("RNZ");
+            fprintf(out, "RNZ");
             break;
         case 0xC1:
-            printf("POP\tB");
+            fprintf(out, "POP\tB");
             break;
         case 0xC2:
-            printf("JNZ\t #$0x%02x%02x", code[2], code[1]);
+            fprintf(out, "JNZ\t #$0x%02x%02x", code[2], code[1]);
             opBytes = 3;
             break;
         case 0xC3:
         case 0xCB:
-            printf("JMP\t #$0x%02x%02x", code[2], code[1]);
+            fprintf(out, "JMP\t #$0x%02x%02x", code[2], code[1]);
             opBytes = 3;
             break;
         case 0xC4:
-            printf("CNZ\t #$0x%02x%02x", code[2], code[1]);
+            fprintf(out, "CNZ\t #$0x%02x%02x", code[2], code[1]);
             opBytes = 3;
             break;
         case 0xC5:
-            printf("PUSH\tB");
+            fprintf(out, "PUSH\tB");
             break;
         case 0xC6:
-            printf("ADI\t #$0x%02x", code[1]);
+            fprintf(out, "ADI\t #$0x%02x", code[1]);
             opBytes = 2;
             break;
         case 0xC7:
-            printf("RST\t0");
+            fprintf(out, "RST\t0");
             break;
         case 0xC8:
-            printf("RZ");
+            fprintf(out, "RZ");
             break;
         case 0xC9:
         case 0xD9:
-            printf("RET");
+            fprintf(out, "RET");
             break;
         case 0xCA:
-            printf("JZ\t #$0x%02x%02x", code[2], code[1]);
+            fprintf(out, "JZ\t #$0x%02x%02x", code[2], code[1]);
             opBytes = 3;
             break;
         case 0xCC:
-            printf("CZ\t #$0x%02x%02x", code[2], code[1]);
+            fprintf(out, "CZ\t #$0x%02x%02x", code[2], code[1]);
             opBytes = 3;
             break;
         case 0xCD:
         case 0xDD:
         case 0xED:
         case 0xFD:
-            printf("CALL\t #$0x%02x%02x", code[2], code[1]);
+            fprintf(out, "CALL\t #$0x%02x%02x", code[2], code[1]);
             opBytes = 3;
             break;
         case 0xCE:
-            printf("ACI\t #$0x%02x", code[1]);
+            fprintf(out, "ACI\t #$0x%02x", code[1]);
             opBytes = 2;
             break;
         case 0xCF:
-            printf("RST\t1");
+            fprintf(out, "RST\t1");
             break;
 
         case 0xD0:
-            printf("RNC");
+            fprintf(out, "RNC");
             break;
         case 0xD1:
-            printf("POP\tD");
+            fprintf(out, "POP\tD");
             break;
         case 0xD2:
-            printf("JNC\t #$0x%02x%02x", code[2], code[1]);
+            fprintf(out, "JNC\t #$0x%02x%02x", code[2], code[1]);
             opBytes = 3;
             break;
         case 0xD3:
-            printf("OUT\t #$0x%02x", code[1]);
+            fprintf(out, "OUT\t #$0x%02x", code[1]);
             opBytes = 2;
             break;
         case 0xD4:
-            printf("CNC\t #$0x%02x%02x", code[2], code[1]);
+            fprintf(out, "CNC\t #$0x%02x%02x", code[2], code[1]);
             opBytes = 3;
             break;
         case 0xD5:
-            printf("PUSH\tD");
+            fprintf(out, "PUSH\tD");
             break;
         case 0xD6:
-            printf("SUI\t #$0x%02x", code[1]);
+            fprintf(out, "SUI\t #$0x%02x", code[1]);
             opBytes = 2;
             break;
         case 0xD7:
-            printf("RST\t2");
+            fprintf(out, "RST\t2");
             break;
         case 0xD8:
-            printf("RC");
+            fprintf(out, "RC");
             break;
         case 0xDA:
-            printf("JC\t #$0x%02x%02x", code[2], code[1]);
+            fprintf(out, "JC\t #$0x%02x%02x", code[2], code[1]);
             opBytes = 3;
             break;
         case 0xDB:
-            printf("IN\t #$0x%02x", code[1]);
+            fprintf(out, "IN\t #$0x%02x", code[1]);
             opBytes = 2;
             break;
         case 0xDC:
-            printf("CC\t #$0x%02x%02x", code[2], code[1]);
+            fprintf(out, "CC\t #$0x%02x%02x", code[2], code[1]);
             opBytes = 3;
             break;
         case 0xDE:
-            printf("SBI\t #$0x%02x", code[1]);
+            fprintf(out, "SBI\t #$0x%02x", code[1]);
             opBytes = 2;
             break;
         case 0xDF:
-            printf("RST\t3");
+            fprintf(out, "RST\t3");
             break;
 
         case 0xE0:
-            printf("RPO");
+            fprintf(out, "RPO");
             break;
         case 0xE1:
-            printf("POP\tH");
+            fprintf(out, "POP\tH");
             break;
         case 0xE2:
-            printf("JPO\t #$0x%02x%02x", code[2], code[1]);
+            fprintf(out, "JPO\t #$0x%02x%02x", code[2], code[1]);
             opBytes = 3;
             break;
         case 0xE3:
-            printf("XTHL");
+            fprintf(out, "XTHL");
             break;
         case 0xE4:
-            printf("CPO\t #$0x%02x%02x", code[2], code[1]);
+            fprintf(out, "CPO\t #$0x%02x%02x", code[2], code[1]);
             opBytes = 3;
             break;
         case 0xE5:
-            printf("PUSH\tH");
+            fprintf(out, "PUSH\tH");
             break;
         case 0xE6:
-            printf("ANI\t #$0x%02x", code[1]);
+            fprintf(out, "ANI\t #$0x%02x", code[1]);
             opBytes = 2;
             break;
         case 0xE7:
-            printf("RST\t4");
+            fprintf(out, "RST\t4");
             break;
         case 0xE8:
-            printf("RPE");
+            fprintf(out, "RPE");
             break;
         case 0xE9:
-            printf("PCHL");
+            fprintf(out, "PCHL");
             break;
         case 0xEA:
-            printf("JPE\t #$0x%02x%02x", code[2], code[1]);
+            fprintf(out, "JPE\t #$0x%02x%02x", code[2], code[1]);
             opBytes = 3;
             break;
         case 0xEB:
-            printf("XCHG");
+            fprintf(out, "XCHG");
             break;
         case 0xEC:
-            printf("CPE\t #$0x%02x%02x", code[2], code[1]);
+            fprintf(out, "CPE\t #$0x%02x%02x", code[2], code[1]);
             opBytes = 3;
             break;
         case 0xEE:
-            printf("XRI\t #$0x%02x", code[1]);
+            fprintf(out, "XRI\t #$0x%02x", code[1]);
             opBytes = 2;
             break;
         case 0xEF:
-            printf("RST\t5");
+            fprintf(out, "RST\t5");
             break;
 
         case 0xF0:
-            printf("RP");
+            fprintf(out, "RP");
             break;
         case 0xF1:
-            printf("POP\tPSW");
+            fprintf(out, "POP\tPSW");
             break;
         case 0xF2:
-            printf("JP\t #$0x%02x%02x", code[2], code[1]);
+            fprintf(out, "JP\t #$0x%02x%02x", code[2], code[1]);
             opBytes = 3;
             break;
         case 0xF3:
-            printf("DI");
+            fprintf(out, "DI");
             break;
         case 0xF4:
-            printf("CP\t #$0x%02x%02x", code[2], code[1]);
+            fprintf(out, "CP\t #$0x%02x%02x", code[2], code[1]);
             opBytes = 3;
             break;
         case 0xF5:
-            printf("PUSH\tPSW");
+            fprintf(out, "PUSH\tPSW");
             break;
         case 0xF6:
-            printf("ORI\t #$0x%02x", code[1]);
+            fprintf(out, "ORI\t #$0x%02x", code[1]);
             opBytes = 2;
             break;
         case 0xF7:
-            printf("RST\t6");
+            fprintf(out, "RST\t6");
             break;
         case 0xF8:
-            printf("RM");
+            fprintf(out, "RM");
             break;
         case 0xF9:
-            printf("SPHL");
+            fprintf(out, "SPHL");
             break;
         case 0xFA:
-            printf("JM\t #$0x%02x%02x", code[2], code[1]);
+            fprintf(out, "JM\t #$0x%02x%02x", code[2], code[1]);
             opBytes = 3;
             break;
         case 0xFB:
-            printf("EI");
+            fprintf(out, "EI");
             break;
         case 0xFC:
-            printf("CM\t #$0x%02x%02x", code[2], code[1]);
+            fprintf(out, "CM\t #$0x%02x%02x", code[2], code[1]);
             opBytes = 3;
             break;
         case 0xFE:
-            printf("CPI\t #$0x%02x", code[1]);
+            fprintf(out, "CPI\t #$0x%02x", code[1]);
             opBytes = 2;
             break;
         case 0xFF:
-            printf("RST\t7");
+            fprintf(out, "RST\t7");
             break;
         default:
-            printf("UNK, 0x%02x", *code);
+            fprintf(out, "UNK, 0x%02x", *code);
             break;
     }
 
-    printf("\n");
+    fprintf(out, "\n");
     return opBytes;
 }
 
@@ -2,6 +2,10 @@
 #define EMULATOR8080_H
 
 #include <cstdint>
+#include <cstdio>
+
+#include "Debugger8080.h"
+#include "Profiler8080.h"
 
 struct ConditionCodes
 {
@@ -10,19 +14,225 @@ struct ConditionCodes
     uint8_t p = 0;
     uint8_t cy = 0;
     uint8_t ac = 0;
+    uint8_t n = 0;      /* Z80: the last arithmetic was a subtraction, for DAA */
+};
+
+struct CpuState
+{
+    uint8_t a = 0;
+    uint8_t b = 0;
+    uint8_t c = 0;
+    uint8_t d = 0;
+    uint8_t e = 0;
+    uint8_t h = 0;
+    uint8_t l = 0;
+    uint16_t sp = 0;
+    uint16_t pc = 0;
+    ConditionCodes cc;
+    uint8_t intEnable = 0;
+    uint8_t halted = 0;
+    uint8_t interruptMasks = 0x07;    /* 8085: RST 5.5-7.5 masks, RST 7.5 pending in bit 6, SOD in bit 7 */
+
+    /* Z80: the index registers, the alternate set as pairs with F in the Z80 layout, the interrupt
+     * vector and refresh registers, the interrupt mode and the IFF2 copy of the interrupt enable */
+    uint16_t ix = 0;
+    uint16_t iy = 0;
+    uint16_t af2 = 0;
+    uint16_t bc2 = 0;
+    uint16_t de2 = 0;
+    uint16_t hl2 = 0;
+    uint8_t i = 0;
+    uint8_t r = 0;
+    uint8_t interruptMode = 0;
+    uint8_t iff2 = 0;
+};
+
+/* Why RunUntil returned. None when it ran up to the target cycle, the others stop the run early
+ * at the instruction given by StopAddress, so a host can fail the one machine and carry on:
+ *   Breakpoint    - the debugger stopped on the instruction, before executing it
+ *   Watchpoint    - the instruction touched watched memory or a watched port
+ *   Halt          - a HLT with interrupts disabled, only the TRAP of an 8085 or the NMI of a Z80
+ *                   resumes the CPU
+ *   IllegalOpcode - an undocumented opcode with strict opcodes on, left unexecuted
+ *   Fault         - a device called Stop on an error of its own */
+enum class StopReason
+{
+    None,
+    Breakpoint,
+    Watchpoint,
+    Halt,
+    IllegalOpcode,
+    Fault
+};
+
+enum class CpuModel
+{
+    Intel8080,
+    Intel8085,
+    Z80
+};
+
+/* Interrupt inputs of the 8085. RST 5.5 and 6.5 are taken while their level is high, RST 7.5 and
+ * TRAP on a rising edge. All but TRAP are masked by SIM and disabled by DI */
+enum class InterruptLine8085
+{
+    Rst55,
+    Rst65,
+    Rst75,
+    Trap
+};
+
+/* Machine cycles reported by the bus timing policy, each at the state it starts on:
+ *   Fetch                - M1, the opcode fetch
+ *   Read, Write          - memory reads and writes, the operand bytes and the stack included
+ *   Input, Output        - port reads and writes
+ *   InterruptAcknowledge - the INTA cycle taking an interrupt, with the handler address and no value */
+enum class BusCycle
+{
+    Fetch,
+    Read,
+    Write,
+    Input,
+    Output,
+    InterruptAcknowledge
+};
+
+/* Compile-time selection of the hooks built into the core, and of the CPU. A hook that is off is
+ * compiled out entirely, so the production core has no per-instruction checks:
+ *   trace     - disassemble every instruction to the trace output
+ *   debug     - test the breakpoint bitmap before every instruction of the run loop
+ *   profile   - report every instruction to the profiler
+ *   watch     - test the watchpoint bitmaps on every data memory access and port access
+ *   busTiming - report every machine cycle to the bus handler at the state it starts on, the
+ *               handler may add wait states. Off, instructions are only charged as a whole
+ *   model     - the 8080, the 8085 with RIM, SIM, its interrupt inputs and its timings, or the Z80
+ *               with its prefixed instructions, registers, flags and timings */
+struct ProductionPolicies
+{
+    static constexpr bool trace = false;
+    static constexpr bool debug = false;
+    static constexpr bool profile = false;
+    static constexpr bool watch = false;
+    static constexpr bool busTiming = false;
+    static constexpr CpuModel model = CpuModel::Intel8080;
+};
+
+struct ProfilePolicies
+{
+    static constexpr bool trace = false;
+    static constexpr bool debug = false;
+    static constexpr bool profile = true;
+    static constexpr bool watch = false;
+    static constexpr bool busTiming = false;
+    static constexpr CpuModel model = CpuModel::Intel8080;
+};
+
+struct DebugPolicies
+{
+    static constexpr bool trace = true;
+    static constexpr bool debug = true;
+    static constexpr bool profile = true;
+    static constexpr bool watch = true;
+    static constexpr bool busTiming = false;
+    static constexpr CpuModel model = CpuModel::Intel8080;
+};
+
+struct BusTimingPolicies : ProductionPolicies
+{
+    static constexpr bool busTiming = true;
+};
+
+struct Intel8085Policies : ProductionPolicies
+{
+    static constexpr CpuModel model = CpuModel::Intel8085;
 };
 
+struct Z80Policies : ProductionPolicies
+{
+    static constexpr CpuModel model = CpuModel::Z80;
+};
+
+template <class Policies = ProductionPolicies>
 class Emulator8080
 {
 public:
+    using InputHandler = uint8_t (*)(void* context, uint8_t port);
+    using OutputHandler = void (*)(void* context, uint8_t port, uint8_t value);
+    using BusHandler = unsigned (*)(void* context, BusCycle cycle, uint16_t address, uint8_t value, uint64_t clock);
+
     Emulator8080();
     explicit Emulator8080(unsigned char* buffer, uint16_t counter = 0);
 
     void Emulate();
+    StopReason RunUntil(uint64_t cycle);
+    void Stop(StopReason reason = StopReason::Fault);
+    void GenerateInterrupt(int number);
+    void GenerateNmi();
+    void SetInterruptLine(InterruptLine8085 line, bool level);
+    void SetSerialInput(bool level);
+    bool SerialOutput() const;
+    void SetIOHandlers(InputHandler input, OutputHandler output, void* context);
+    void SetBusHandler(BusHandler handler, void* context);
+
+    void SetTraceOutput(FILE* out);
+    void SetProfiler(Profiler8080* profiler);
+    void SetDebugger(Debugger8080* debugger);
+    void SetIdleSkip(bool enabled);
+    void SetStrictOpcodes(bool enabled);
+
     uint16_t ProgramCounter() const;
+    bool Halted() const;
+    uint16_t StopAddress() const;
+    uint64_t Cycles() const;
+    uint64_t SkippedCycles() const;
+
+    CpuState State() const;
+    void SetState(const CpuState& state);
+    void SetCycles(uint64_t count);
 
 private:
-    static void UnimplementedInstruction();
+    static constexpr bool is8085 = Policies::model == CpuModel::Intel8085;
+    static constexpr bool isZ80 = Policies::model == CpuModel::Z80;
+    static_assert(!(Policies::busTiming && isZ80), "Bus timing is modelled for the 8080 and 8085 only");
+    static_assert(!Policies::profile || Policies::model == CpuModel::Intel8080,
+                  "The profiler tells calls and returns by the opcodes of the 8080 only");
+
+    /* States added to the table's count when a conditional jump, call or return is taken */
+    static constexpr int jumpTaken = is8085 ? 3 : 0;
+    static constexpr int callTaken = is8085 ? 9 : isZ80 ? 7 : 6;
+    static constexpr int returnTaken = 6;
+    static constexpr int relativeTaken = 5;
+
+    /* Bytes of the longest instruction, the prefixed DD CB and ED ones on the Z80 */
+    static constexpr int maxInstructionLength = isZ80 ? 4 : 3;
+
+    static uint8_t opCycles(uint8_t opCode);
+    static uint8_t fetchStates(uint8_t opCode);
+    static uint8_t instructionLength(uint8_t opCode);
+
+    void execute();
+    uint8_t* instructionBytes();
+    uint8_t readMemory(uint16_t address);
+    void writeMemory(uint16_t address, uint8_t value);
+    uint16_t readWord(uint16_t address);
+    void writeWord(uint16_t address, uint16_t value);
+    static uint16_t wordAt(const uint8_t* bytes);
+    void watchHit(Debugger8080::Event event, uint16_t address, uint8_t value);
+    void fetchCycles(const uint8_t* opCode);
+    bool conditionMet(uint8_t opCode) const;
+    void busCycle(BusCycle cycle, uint16_t address, uint8_t value, unsigned states);
+    void illegalOpcode();
+    void skipIdleLoop(uint16_t from, uint64_t cycle);
+    void interrupt(uint16_t address);
+    uint8_t input(uint8_t port);
+    void output(uint8_t port, uint8_t value);
+    void acceptInterrupt();
+    void readInterruptMask();
+    void setInterruptMask();
+    uint64_t registerSnapshot() const;
+    uint64_t statusSnapshot() const;
+    uint64_t indexSnapshot() const;
+    uint64_t alternateSnapshot() const;
 
     void setFlags(uint16_t ans);
 
@@ -30,12 +240,12 @@ private:
     void addRegisterCarry(uint8_t reg);
     void subtractRegister(uint8_t reg);
     void subtractRegisterBorrow(uint8_t reg);
-    void addPairToHL(uint8_t reg1, uint8_t reg2);
+    void addPairToHL(uint16_t pair);
     void decimalAdjustAcc();
-    void incrementRegister(uint8_t& reg);
-    static void incrementRegPair(uint8_t& reg1, uint8_t& reg2);
-    void decrementRegister(uint8_t& reg);
-    static void decrementRegPair(uint8_t& reg1, uint8_t& reg2);
+    uint8_t incrementRegister(uint8_t reg);
+    uint8_t decrementRegister(uint8_t reg);
+    void incrementMemory(uint16_t address);
+    void decrementMemory(uint16_t address);
 
     void logicalAndRegister(uint8_t reg);
     void logicalXOrRegister(uint8_t reg);
@@ -46,25 +256,118 @@ private:
     void rotateRight();
     void rotateRightCarry();
 
-    void call(uint8_t byte1, uint8_t byte2);
+    void call(uint16_t address);
     void ret();
     void rst(int nnn);
 
-    void pushPair(uint8_t reg1, uint8_t reg2);
+    void pushPair(uint16_t pair);
     void pushPSW();
-    void popPair(uint8_t& reg1, uint8_t& reg2);
+    void popPair(uint16_t& pair);
     void popPSW();
+    uint8_t flagsByte() const;
+    void setFlagsByte(uint8_t psw);
 
     void xthl();
 
     static uint8_t Parity(uint16_t ans);
 
+    /* The 8-bit registers, the high and low bytes of the register pairs */
+    uint8_t b() const { return bc >> 8; }
+    uint8_t c() const { return bc & 0xFF; }
+    uint8_t d() const { return de >> 8; }
+    uint8_t e() const { return de & 0xFF; }
+    uint8_t h() const { return hl >> 8; }
+    uint8_t l() const { return hl & 0xFF; }
+    void setB(uint8_t value) { bc = (bc & 0x00FF) | (value << 8); }
+    void setC(uint8_t value) { bc = (bc & 0xFF00) | value; }
+    void setD(uint8_t value) { de = (de & 0x00FF) | (value << 8); }
+    void setE(uint8_t value) { de = (de & 0xFF00) | value; }
+    void setH(uint8_t value) { hl = (hl & 0x00FF) | (value << 8); }
+    void setL(uint8_t value) { hl = (hl & 0xFF00) | value; }
+
+    /* Z80 instructions, the prefixed ones in Z80Prefixed.inl */
+    void refresh();
+    void jumpRelative(bool condition);
+    void exchangeAF();
+    void exchangeRegisters();
+    void executeCB();
+    void executeED();
+    bool executeIndexed(uint16_t& index);
+    void executeIndexedCB(uint16_t address, uint8_t opCode);
+    uint8_t registerAt(int index) const;
+    void setRegisterAt(int index, uint8_t value);
+    uint16_t pairAt(int index) const;
+    void setPairAt(int index, uint16_t value);
+    void arithmetic(int operation, uint8_t value);
+    uint8_t rotateShift(int operation, uint8_t value);
+    void testBit(int bit, uint8_t value);
+    void addPairCarry(uint16_t pair);
+    void subtractPairBorrow(uint16_t pair);
+    void rotateDigit(bool left);
+    bool blockTransfer(int step);
+    bool blockCompare(int step);
+    bool blockInput(int step);
+    bool blockOutput(int step);
+
 private:
-    uint8_t a, b, c, d, e, h, l;
+    uint8_t a;
+    uint16_t bc, de, hl;
     uint16_t sp, pc;
     uint8_t *memory;
     uint8_t intEnable;
     ConditionCodes cc;
+    uint64_t cycles;
+    uint32_t sideEffects;
+    uint8_t wrappedBytes[4];
+
+    InputHandler inputHandler;
+    OutputHandler outputHandler;
+    void* ioContext;
+    BusHandler busHandler;
+    void* busContext;
+    uint64_t busClock;
+
+    FILE* traceOutput;
+    Profiler8080* profiler;
+    Debugger8080* debugger;
+    uint32_t resumeAddress;
+    uint64_t runTarget;
+    StopReason stopReason;
+    uint16_t stopAddress;
+    bool halted;
+    bool strictOpcodes;
+    uint8_t interruptMasks;
+    uint8_t interruptLines;
+    bool interruptDelay;
+
+    uint16_t ix, iy;
+    uint16_t af2, bc2, de2, hl2;
+    uint8_t interruptVector;
+    uint8_t refreshCounter;
+    uint8_t interruptMode;
+    uint8_t iff2;
+
+    bool idleSkip;
+    uint32_t loopHead;
+    uint32_t loopEffects;
+    uint64_t loopCycles;
+    uint64_t loopRegisters;
+    uint64_t loopStatus;
+    uint64_t loopIndex;
+    uint64_t loopAlternates;
+    uint8_t loopRefresh;
+    uint8_t loopMisses[64];
+    uint64_t skippedCycles;
 };
 
-#endif
\ No newline at end of file
+#include "Emulator8080.inl"
+#include "Z80Prefixed.inl"
+
+extern template class Emulator8080<ProductionPolicies>;
+extern template class Emulator8080<ProfilePolicies>;
+extern template class Emulator8080<DebugPolicies>;
+extern template class Emulator8080<BusTimingPolicies>;
+extern template class Emulator8080<Intel8085Policies>;
+extern template class Emulator8080<Z80Policies>;
+
+#endif
@@ -0,0 +1,2204 @@
+/* Definitions of the Emulator8080 template, included by Emulator8080.h */
+
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#include "Disassembler8080.h"
+
+
+/* Number of clock states taken by every opcode. Conditional calls and returns
+ * list the not-taken count, taking the branch costs 6 more states */
+inline constexpr uint8_t cycles8080[256] = {
+    4, 10, 7, 5, 5, 5, 7, 4, 4, 10, 7, 5, 5, 5, 7, 4,           /* 0x00 */
+    4, 10, 7, 5, 5, 5, 7, 4, 4, 10, 7, 5, 5, 5, 7, 4,           /* 0x10 */
+    4, 10, 16, 5, 5, 5, 7, 4, 4, 10, 16, 5, 5, 5, 7, 4,         /* 0x20 */
+    4, 10, 13, 5, 10, 10, 10, 4, 4, 10, 13, 5, 5, 5, 7, 4,      /* 0x30 */
+    5, 5, 5, 5, 5, 5, 7, 5, 5, 5, 5, 5, 5, 5, 7, 5,             /* 0x40 */
+    5, 5, 5, 5, 5, 5, 7, 5, 5, 5, 5, 5, 5, 5, 7, 5,             /* 0x50 */
+    5, 5, 5, 5, 5, 5, 7, 5, 5, 5, 5, 5, 5, 5, 7, 5,             /* 0x60 */
+    7, 7, 7, 7, 7, 7, 7, 7, 5, 5, 5, 5, 5, 5, 7, 5,             /* 0x70 */
+    4, 4, 4, 4, 4, 4, 7, 4, 4, 4, 4, 4, 4, 4, 7, 4,             /* 0x80 */
+    4, 4, 4, 4, 4, 4, 7, 4, 4, 4, 4, 4, 4, 4, 7, 4,             /* 0x90 */
+    4, 4, 4, 4, 4, 4, 7, 4, 4, 4, 4, 4, 4, 4, 7, 4,             /* 0xA0 */
+    4, 4, 4, 4, 4, 4, 7, 4, 4, 4, 4, 4, 4, 4, 7, 4,             /* 0xB0 */
+    5, 10, 10, 10, 11, 11, 7, 11, 5, 10, 10, 10, 11, 17, 7, 11, /* 0xC0 */
+    5, 10, 10, 10, 11, 11, 7, 11, 5, 10, 10, 10, 11, 17, 7, 11, /* 0xD0 */
+    5, 10, 10, 18, 11, 11, 7, 11, 5, 5, 10, 4, 11, 17, 7, 11,   /* 0xE0 */
+    5, 10, 10, 4, 11, 11, 7, 11, 5, 5, 10, 4, 11, 17, 7, 11     /* 0xF0 */
+};
+
+/* The same for the 8085, which is faster on register moves and slower on pair increments, stack
+ * writes and calls. Conditional jumps list the not-taken count, taking them costs 3 more states,
+ * conditional calls 9 more. The undocumented opcodes keep the timings of their 8080 aliases */
+inline constexpr uint8_t cycles8085[256] = {
+    4, 10, 7, 6, 4, 4, 7, 4, 4, 10, 7, 6, 4, 4, 7, 4,       /* 0x00 */
+    4, 10, 7, 6, 4, 4, 7, 4, 4, 10, 7, 6, 4, 4, 7, 4,       /* 0x10 */
+    4, 10, 16, 6, 4, 4, 7, 4, 4, 10, 16, 6, 4, 4, 7, 4,     /* 0x20 */
+    4, 10, 13, 6, 10, 10, 10, 4, 4, 10, 13, 6, 4, 4, 7, 4,  /* 0x30 */
+    4, 4, 4, 4, 4, 4, 7, 4, 4, 4, 4, 4, 4, 4, 7, 4,         /* 0x40 */
+    4, 4, 4, 4, 4, 4, 7, 4, 4, 4, 4, 4, 4, 4, 7, 4,         /* 0x50 */
+    4, 4, 4, 4, 4, 4, 7, 4, 4, 4, 4, 4, 4, 4, 7, 4,         /* 0x60 */
+    7, 7, 7, 7, 7, 7, 5, 7, 4, 4, 4, 4, 4, 4, 7, 4,         /* 0x70 */
+    4, 4, 4, 4, 4, 4, 7, 4, 4, 4, 4, 4, 4, 4, 7, 4,         /* 0x80 */
+    4, 4, 4, 4, 4, 4, 7, 4, 4, 4, 4, 4, 4, 4, 7, 4,         /* 0x90 */
+    4, 4, 4, 4, 4, 4, 7, 4, 4, 4, 4, 4, 4, 4, 7, 4,         /* 0xA0 */
+    4, 4, 4, 4, 4, 4, 7, 4, 4, 4, 4, 4, 4, 4, 7, 4,         /* 0xB0 */
+    6, 10, 7, 10, 9, 12, 7, 12, 6, 10, 7, 10, 9, 18, 7, 12, /* 0xC0 */
+    6, 10, 7, 10, 9, 12, 7, 12, 6, 10, 7, 10, 9, 18, 7, 12, /* 0xD0 */
+    6, 10, 7, 16, 9, 12, 7, 12, 6, 6, 7, 4, 9, 18, 7, 12,   /* 0xE0 */
+    6, 10, 7, 4, 9, 12, 7, 12, 6, 6, 7, 4, 9, 18, 7, 12     /* 0xF0 */
+};
+
+/* The same for the Z80. Conditional calls take 7 more states, relative jumps and DJNZ 5 more. The
+ * prefixes list nothing, the prefixed tables charge the whole instruction */
+inline constexpr uint8_t cyclesZ80[256] = {
+    4, 10, 7, 6, 4, 4, 7, 4, 4, 11, 7, 6, 4, 4, 7, 4,           /* 0x00 */
+    8, 10, 7, 6, 4, 4, 7, 4, 7, 11, 7, 6, 4, 4, 7, 4,           /* 0x10 */
+    7, 10, 16, 6, 4, 4, 7, 4, 7, 11, 16, 6, 4, 4, 7, 4,         /* 0x20 */
+    7, 10, 13, 6, 11, 11, 10, 4, 7, 11, 13, 6, 4, 4, 7, 4,      /* 0x30 */
+    4, 4, 4, 4, 4, 4, 7, 4, 4, 4, 4, 4, 4, 4, 7, 4,             /* 0x40 */
+    4, 4, 4, 4, 4, 4, 7, 4, 4, 4, 4, 4, 4, 4, 7, 4,             /* 0x50 */
+    4, 4, 4, 4, 4, 4, 7, 4, 4, 4, 4, 4, 4, 4, 7, 4,             /* 0x60 */
+    7, 7, 7, 7, 7, 7, 4, 7, 4, 4, 4, 4, 4, 4, 7, 4,             /* 0x70 */
+    4, 4, 4, 4, 4, 4, 7, 4, 4, 4, 4, 4, 4, 4, 7, 4,             /* 0x80 */
+    4, 4, 4, 4, 4, 4, 7, 4, 4, 4, 4, 4, 4, 4, 7, 4,             /* 0x90 */
+    4, 4, 4, 4, 4, 4, 7, 4, 4, 4, 4, 4, 4, 4, 7, 4,             /* 0xA0 */
+    4, 4, 4, 4, 4, 4, 7, 4, 4, 4, 4, 4, 4, 4, 7, 4,             /* 0xB0 */
+    5, 10, 10, 10, 10, 11, 7, 11, 5, 10, 10, 0, 10, 17, 7, 11,  /* 0xC0 */
+    5, 10, 10, 11, 10, 11, 7, 11, 5, 4, 10, 11, 10, 0, 7, 11,   /* 0xD0 */
+    5, 10, 10, 19, 10, 11, 7, 11, 5, 4, 10, 4, 10, 0, 7, 11,    /* 0xE0 */
+    5, 10, 10, 4, 10, 11, 7, 11, 5, 6, 10, 4, 10, 0, 7, 11      /* 0xF0 */
+};
+
+/* Bits of the 8085 interrupt inputs, where RIM reports them. TRAP, which RIM leaves out, latches
+ * into bit 3 of the inputs, the pending RST 7.5 and SOD are kept with the masks */
+inline constexpr uint8_t rst55Pending = 0x10;
+inline constexpr uint8_t rst65Pending = 0x20;
+inline constexpr uint8_t rst75Pending = 0x40;
+inline constexpr uint8_t trapPending = 0x08;
+inline constexpr uint8_t serialBit = 0x80;
+
+/* Whether the host keeps words low byte first as the 8080 does, so memory words load as they are */
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+inline constexpr bool hostLittleEndian = false;
+#else
+inline constexpr bool hostLittleEndian = true;
+#endif
+
+/* Longest backward jump, in bytes, still taken for a loop that may be idle */
+inline constexpr uint16_t maxIdleLoop = 64;
+
+
+template <class Policies>
+Emulator8080<Policies>::Emulator8080() : a(0), bc(0), de(0), hl(0), sp(0), pc(0),
+    memory(nullptr), intEnable(1), cycles(0), sideEffects(0), wrappedBytes(),
+    inputHandler(nullptr), outputHandler(nullptr), ioContext(nullptr), busHandler(nullptr), busContext(nullptr),
+    busClock(0),
+    traceOutput(nullptr), profiler(nullptr), debugger(nullptr),
+    resumeAddress(0x10000), runTarget(0), stopReason(StopReason::None), stopAddress(0), halted(false),
+    strictOpcodes(false), interruptMasks(0x07), interruptLines(0), interruptDelay(false),
+    ix(0), iy(0), af2(0), bc2(0), de2(0), hl2(0), interruptVector(0), refreshCounter(0),
+    interruptMode(0), iff2(0), idleSkip(false), loopHead(0x10000), loopEffects(0),
+    loopCycles(0), loopRegisters(0), loopStatus(0), loopIndex(0), loopAlternates(0), loopRefresh(0), loopMisses(),
+    skippedCycles(0)
+{ }
+
+template <class Policies>
+Emulator8080<Policies>::Emulator8080(unsigned char* buffer, uint16_t counter) : a(0), bc(0), de(0), hl(0),
+    sp(0), pc(counter), memory(buffer), intEnable(1), cycles(0), sideEffects(0), wrappedBytes(),
+    inputHandler(nullptr), outputHandler(nullptr), ioContext(nullptr), busHandler(nullptr), busContext(nullptr),
+    busClock(0),
+    traceOutput(nullptr), profiler(nullptr), debugger(nullptr),
+    resumeAddress(0x10000), runTarget(0), stopReason(StopReason::None), stopAddress(0), halted(false),
+    strictOpcodes(false), interruptMasks(0x07), interruptLines(0), interruptDelay(false),
+    ix(0), iy(0), af2(0), bc2(0), de2(0), hl2(0), interruptVector(0), refreshCounter(0),
+    interruptMode(0), iff2(0), idleSkip(false), loopHead(0x10000), loopEffects(0),
+    loopCycles(0), loopRegisters(0), loopStatus(0), loopIndex(0), loopAlternates(0), loopRefresh(0), loopMisses(),
+    skippedCycles(0)
+{ }
+
+/* Read data memory, reporting the access when it is watched */
+template <class Policies>
+inline uint8_t Emulator8080<Policies>::readMemory(uint16_t address) {
+    uint8_t value = memory[address];
+    if constexpr (Policies::busTiming)
+        busCycle(BusCycle::Read, address, value, 3);
+    if constexpr (Policies::watch) {
+        if (debugger && debugger->IsReadWatched(address))
+            watchHit(Debugger8080::Event::MemoryRead, address, value);
+    }
+    return value;
+}
+
+/* Write data memory, reporting the access when it is watched */
+template <class Policies>
+inline void Emulator8080<Policies>::writeMemory(uint16_t address, uint8_t value) {
+    if constexpr (Policies::busTiming)
+        busCycle(BusCycle::Write, address, value, 3);
+    if constexpr (Policies::watch) {
+        if (debugger && debugger->IsWriteWatched(address))
+            watchHit(Debugger8080::Event::MemoryWrite, address, value);
+    }
+    memory[address] = value;
+    ++sideEffects;
+}
+
+/* The bytes of the instruction at PC. An instruction ending past 0xFFFF is copied into a buffer
+ * continuing at 0x0000, where the CPU fetches its operands, instead of reading past the end of memory */
+template <class Policies>
+inline uint8_t* Emulator8080<Policies>::instructionBytes() {
+    if (pc <= 0x10000 - maxInstructionLength)
+        return &memory[pc];
+    for (int i = 0; i < maxInstructionLength; i++)
+        wrappedBytes[i] = memory[static_cast<uint16_t>(pc + i)];
+    return wrappedBytes;
+}
+
+/* Read a little-endian word of data memory. Without hooks on the accesses, and on a little-endian
+ * host, that is one load unless the word wraps around the end of memory */
+template <class Policies>
+inline uint16_t Emulator8080<Policies>::readWord(uint16_t address) {
+    if constexpr (!Policies::watch && !Policies::busTiming && hostLittleEndian) {
+        if (address != 0xFFFF) {
+            uint16_t value;
+            memcpy(&value, memory + address, 2);
+            return value;
+        }
+    }
+    uint8_t low = readMemory(address);
+    return low | (readMemory(address + 1) << 8);
+}
+
+/* Write a little-endian word of data memory, the high byte first as the stack pushes do */
+template <class Policies>
+inline void Emulator8080<Policies>::writeWord(uint16_t address, uint16_t value) {
+    if constexpr (!Policies::watch && !Policies::busTiming && hostLittleEndian) {
+        if (address != 0xFFFF) {
+            memcpy(memory + address, &value, 2);
+            ++sideEffects;
+            return;
+        }
+    }
+    writeMemory(address + 1, value >> 8);
+    writeMemory(address, value & 0xFF);
+}
+
+/* The little-endian word of the operand bytes of an instruction */
+template <class Policies>
+inline uint16_t Emulator8080<Policies>::wordAt(const uint8_t* bytes) {
+    if constexpr (hostLittleEndian) {
+        uint16_t value;
+        memcpy(&value, bytes, 2);
+        return value;
+    }
+    else
+        return bytes[0] | (bytes[1] << 8);
+}
+
+/* Slow path of a watched access, the run loop stops after the instruction when the debugger wants it */
+template <class Policies>
+void Emulator8080<Policies>::watchHit(Debugger8080::Event event, uint16_t address, uint8_t value) {
+    if (debugger->Trigger(event, pc, address, value))
+        Stop(StopReason::Watchpoint);
+}
+
+/* Clock states of the opcode on the CPU of the policies, not counting taken branches */
+template <class Policies>
+inline uint8_t Emulator8080<Policies>::opCycles(uint8_t opCode) {
+    if constexpr (is8085)
+        return cycles8085[opCode];
+    else if constexpr (isZ80)
+        return cyclesZ80[opCode];
+    else
+        return cycles8080[opCode];
+}
+
+/* States of the opcode fetch, M1. It takes 4, or 5 on the 8080 and 6 on the 8085 for the opcodes
+ * working on a register pair or the stack pointer before their first bus cycle, and on the 8080
+ * for the register moves, increments and decrements */
+template <class Policies>
+uint8_t Emulator8080<Policies>::fetchStates(uint8_t opCode) {
+    if ((opCode & 0xC7) == 0x03 || (opCode & 0xC7) == 0xC0 || (opCode & 0xC7) == 0xC4 || (opCode & 0xC7) == 0xC7 ||
+        (opCode & 0xCF) == 0xC5 || (opCode & 0xCF) == 0xCD || opCode == 0xE9 || opCode == 0xF9)
+        return is8085 ? 6 : 5;
+
+    if constexpr (!is8085) {
+        bool memoryOperand = (opCode & 0x07) == 0x06 || (opCode & 0x38) == 0x30;
+        bool move = opCode >= 0x40 && opCode < 0x80;
+        bool step = (opCode & 0xC6) == 0x04;
+        if ((move || step) && !memoryOperand)
+            return 5;
+    }
+    return 4;
+}
+
+/* Bytes of the instruction, the opcode and its operands */
+template <class Policies>
+uint8_t Emulator8080<Policies>::instructionLength(uint8_t opCode) {
+    if ((opCode & 0xCF) == 0x01 || (opCode & 0xE7) == 0x22 || (opCode & 0xC7) == 0xC2 || (opCode & 0xC7) == 0xC4 ||
+        opCode == 0xC3 || opCode == 0xCB || (opCode & 0xCF) == 0xCD)
+        return 3;
+    if ((opCode & 0xC7) == 0x06 || (opCode & 0xC7) == 0xC6 || opCode == 0xD3 || opCode == 0xDB)
+        return 2;
+    return 1;
+}
+
+/* Bus timing: the M1 of the opcode and the reads of its operand bytes, from the state the
+ * instruction starts on. The states of the instruction beyond its machine cycles, as the internal
+ * ones of DAD, are left at its end. A halted CPU does not fetch */
+template <class Policies>
+void Emulator8080<Policies>::fetchCycles(const uint8_t* opCode) {
+    busClock = cycles;
+    if (halted)
+        return;
+
+    busCycle(BusCycle::Fetch, pc, opCode[0], fetchStates(opCode[0]));
+    uint8_t length = instructionLength(opCode[0]);
+
+    /* The 8085 does not read the high address byte of a conditional jump or call it does not take */
+    if constexpr (is8085) {
+        if (((opCode[0] & 0xC7) == 0xC2 || (opCode[0] & 0xC7) == 0xC4) && !conditionMet(opCode[0]))
+            length = 2;
+    }
+    for (uint8_t i = 1; i < length; i++)
+        busCycle(BusCycle::Read, pc + i, opCode[i], 3);
+}
+
+/* Whether the condition in bits 3-5 of a conditional jump, call or return holds: NZ, Z, NC, C, PO, PE, P, M */
+template <class Policies>
+inline bool Emulator8080<Policies>::conditionMet(uint8_t opCode) const {
+    const uint8_t flags[4] = { cc.z, cc.cy, cc.p, cc.s };
+    int condition = (opCode >> 3) & 0x07;
+    return flags[condition >> 1] == (condition & 1);
+}
+
+/* Report a machine cycle at the state it starts on, charging the wait states the handler asks for */
+template <class Policies>
+inline void Emulator8080<Policies>::busCycle(BusCycle cycle, uint16_t address, uint8_t value, unsigned states) {
+    if (busHandler) {
+        unsigned waits = busHandler(busContext, cycle, address, value, busClock);
+        cycles += waits;
+        busClock += waits;
+    }
+    busClock += states;
+}
+
+/* An undocumented opcode with strict opcodes on, the run stops before it as if it was never fetched */
+template <class Policies>
+void Emulator8080<Policies>::illegalOpcode() {
+    cycles -= opCycles(memory[pc]);
+    Stop(StopReason::IllegalOpcode);
+}
+
+/* Check if the number of even bits is even */
+template <class Policies>
+uint8_t Emulator8080<Policies>::Parity(uint16_t ans) {
+    uint8_t num = ans & 0xFF; /* Take the lower bits */
+    int size = 8;
+    int count = 0;
+
+    /* Check every bit. If it's 1, add to the even count */
+    for (int i = 0; i < size; i++) {
+        if (num & 0x1)
+            ++count;
+        num >>= 1;
+    }
+
+    /* Return whether count is odd or even */
+    return (count & 0x1) == 0;
+}
+
+/* Set the basic flags */
+template <class Policies>
+void Emulator8080<Policies>::setFlags(uint16_t ans) {
+    cc.z = ((ans & 0xFF) == 0 ? 1 : 0);
+    cc.s = ((ans & 0x80) ? 1 : 0);
+    cc.p = Parity(ans & 0xFF);
+}
+
+/* Add a register to the accumulator */
+template <class Policies>
+void Emulator8080<Policies>::addRegister(uint8_t reg) {
+    uint16_t ans = a + static_cast<uint16_t>(reg);
+    setFlags(ans);
+    /* Set the rest of flags */
+    cc.cy = ans > 0xFF;
+    cc.ac = ((a & 0xF) + (reg & 0xF)) > 0xF;
+    if constexpr (isZ80) {
+        /* P/V is the overflow on the Z80 */
+        cc.p = ((a ^ ~reg) & (a ^ ans) & 0x80) != 0;
+        cc.n = 0;
+    }
+
+    a = ans & 0xFF;
+}
+
+/* Add a register and the carry bit to the accumulator */
+template <class Policies>
+void Emulator8080<Policies>::addRegisterCarry(uint8_t reg) {
+    uint8_t carry = cc.cy;
+    uint16_t ans = a + static_cast<uint16_t>(reg) + carry;
+    setFlags(ans);
+    /* Set the rest of flags */
+    cc.cy = ans > 0xFF;
+    cc.ac = ((a & 0xF) + (reg & 0xF) + carry) > 0xF;
+    if constexpr (isZ80) {
+        cc.p = ((a ^ ~reg) & (a ^ ans) & 0x80) != 0;
+        cc.n = 0;
+    }
+
+    a = ans & 0xFF;
+}
+
+/* Subtract a register from the accumulator. The 8080 adds the complement, the Carry flag is
+ * the inverted carry out of bit 7, the Auxiliary Carry the carry out of bit 3 as it is.
+ * The Z80 sets both as borrows, and P/V to the overflow */
+template <class Policies>
+void Emulator8080<Policies>::subtractRegister(uint8_t reg) {
+    uint16_t ans = static_cast<uint16_t>(a) - reg;
+    setFlags(ans);
+    /* Set the rest of flags */
+    cc.cy = a < reg;
+    if constexpr (isZ80) {
+        cc.ac = (a & 0xF) < (reg & 0xF);
+        cc.p = ((a ^ reg) & (a ^ ans) & 0x80) != 0;
+        cc.n = 1;
+    }
+    else
+        cc.ac = ((a & 0xF) + (~reg & 0xF) + 1) > 0xF;
+
+    a = ans & 0xFF;
+}
+
+/* Subtract a register and the carry bit from the accumulator */
+template <class Policies>
+void Emulator8080<Policies>::subtractRegisterBorrow(uint8_t reg) {
+    uint8_t borrow = cc.cy;
+    uint16_t ans = static_cast<uint16_t>(a) - static_cast<uint16_t>(reg) - borrow;
+    setFlags(ans);
+    /* Set the rest of flags */
+    cc.cy = a < reg + borrow;
+    if constexpr (isZ80) {
+        cc.ac = (a & 0xF) < (reg & 0xF) + borrow;
+        cc.p = ((a ^ reg) & (a ^ ans) & 0x80) != 0;
+        cc.n = 1;
+    }
+    else
+        cc.ac = ((a & 0xF) + (~reg & 0xF) + !borrow) > 0xF;
+
+    a = ans & 0xFF;
+}
+
+/* Increment the register, returns the result */
+template <class Policies>
+uint8_t Emulator8080<Policies>::incrementRegister(uint8_t reg) {
+    uint16_t ans = static_cast<uint16_t>(reg) + 1;
+    setFlags(ans);
+    /* Set the rest of flags */
+    cc.ac = ((reg & 0xF) + 1) > 0xF;
+    if constexpr (isZ80) {
+        cc.p = reg == 0x7F;
+        cc.n = 0;
+    }
+
+    return ans & 0xFF;
+}
+
+/* Increment the memory pointed by the address */
+template <class Policies>
+void Emulator8080<Policies>::incrementMemory(uint16_t address) {
+    writeMemory(address, incrementRegister(readMemory(address)));
+}
+
+/* Decrement the register, returns the result */
+template <class Policies>
+uint8_t Emulator8080<Policies>::decrementRegister(uint8_t reg) {
+    uint16_t ans = static_cast<uint16_t>(reg) - 1;
+    setFlags(ans);
+    /* Set the rest of flags */
+    if constexpr (isZ80) {
+        cc.ac = (reg & 0xF) == 0;
+        cc.p = reg == 0x80;
+        cc.n = 1;
+    }
+    else
+        cc.ac = (reg & 0xF) != 0;
+
+    return ans & 0xFF;
+}
+
+/* Decrement the memory pointed by the address */
+template <class Policies>
+void Emulator8080<Policies>::decrementMemory(uint16_t address) {
+    writeMemory(address, decrementRegister(readMemory(address)));
+}
+
+/* Add a register pair to the H and L registers */
+template <class Policies>
+void Emulator8080<Policies>::addPairToHL(uint16_t pair) {
+    uint32_t ans = pair + hl;
+
+    cc.cy = ans > 0xFFFF;
+    if constexpr (isZ80) {
+        cc.ac = ((pair & 0xFFF) + (hl & 0xFFF)) > 0xFFF;
+        cc.n = 0;
+    }
+
+    hl = ans & 0xFFFF;
+}
+
+/* Decimal adjust the accumulator. Both corrections are decided on the accumulator as it is and
+ * added at once, the Carry flag is only ever set, never cleared. The Z80 subtracts them after a
+ * subtraction, P/V is the parity of the result */
+template <class Policies>
+void Emulator8080<Policies>::decimalAdjustAcc() {
+    uint8_t correction = 0;
+    uint8_t carry = cc.cy;
+    if ((a & 0x0F) > 9 || cc.ac)
+        correction |= 0x06;
+
+    if (a > 0x99 || cc.cy) {
+        correction |= 0x60;
+        carry = 1;
+    }
+
+    if constexpr (isZ80) {
+        if (cc.n) {
+            cc.ac = cc.ac && (a & 0x0F) < 6;
+            a -= correction;
+        }
+        else {
+            cc.ac = (a & 0x0F) > 9;
+            a += correction;
+        }
+        setFlags(a);
+    }
+    else
+        addRegister(correction);
+    cc.cy = carry;
+}
+
+/* Set the accumulator to the result of logical AND with a register */
+template <class Policies>
+void Emulator8080<Policies>::logicalAndRegister(uint8_t reg) {
+    uint16_t ans = a & reg;
+    setFlags(ans);
+    /* Reset the Carry flag, the Auxiliary Carry is the OR of bit 3 of the operands, on the 8085 and Z80 set */
+    cc.cy = 0;
+    cc.n = 0;
+    if constexpr (is8085 || isZ80)
+        cc.ac = 1;
+    else
+        cc.ac = ((a | reg) & 0x08) != 0;
+    a = ans;
+}
+
+/* Set the accumulator to the result of logical XOR with a register */
+template <class Policies>
+void Emulator8080<Policies>::logicalXOrRegister(uint8_t reg) {
+    uint16_t ans = a ^ reg;
+    setFlags(ans);
+    /* Reset the Carry flags */
+    cc.cy = 0;
+    cc.ac = 0;
+    cc.n = 0;
+    a = ans;
+}
+
+/* Set the accumulator to the result of logical OR with a register */
+template <class Policies>
+void Emulator8080<Policies>::logicalOrRegister(uint8_t reg) {
+    uint16_t ans = a | reg;
+    setFlags(ans);
+    /* Reset the Carry flags */
+    cc.cy = 0;
+    cc.ac = 0;
+    cc.n = 0;
+    a = ans;
+}
+
+/* Compare the accumulator with a register, set flags as a subtraction would */
+template <class Policies>
+void Emulator8080<Policies>::compareRegister(uint8_t reg) {
+    uint16_t ans = a - reg;
+    setFlags(ans);
+    /* Set the rest of flags */
+    cc.cy = a < reg;
+    if constexpr (isZ80) {
+        cc.ac = (a & 0x0F) < (reg & 0x0F);
+        cc.p = ((a ^ reg) & (a ^ ans) & 0x80) != 0;
+        cc.n = 1;
+    }
+    else
+        cc.ac = ((a & 0x0F) + (~reg & 0x0F) + 1) > 0x0F;
+}
+
+/* Rotate content of the accumulator one place left, update the Carry flag */
+template <class Policies>
+void Emulator8080<Policies>::rotateLeft() {
+    uint8_t oldVal = a;
+    a = (((oldVal & 0x80) >> 7) | (oldVal << 1));
+    cc.cy = (a & 1);
+    if constexpr (isZ80)
+        cc.ac = cc.n = 0;
+}
+
+/* Rotate content of the accumulator one place left,
+ * set the LSB bit to the Carry flag, update it */
+template <class Policies>
+void Emulator8080<Policies>::rotateLeftCarry() {
+    uint8_t oldVal = a;
+    a = ((oldVal << 1) | cc.cy);
+    cc.cy = (oldVal >> 7);
+    if constexpr (isZ80)
+        cc.ac = cc.n = 0;
+}
+
+/* Rotate content of the accumulator one place right, update the Carry flag */
+template <class Policies>
+void Emulator8080<Policies>::rotateRight() {
+    uint8_t oldVal = a;
+    a = (((oldVal & 1) << 7) | (oldVal >> 1));
+    cc.cy = (oldVal & 1);
+    if constexpr (isZ80)
+        cc.ac = cc.n = 0;
+}
+
+/* Rotate content of the accumulator one place right,
+ * set the MSB to the Carry flag, update it */
+template <class Policies>
+void Emulator8080<Policies>::rotateRightCarry() {
+    uint8_t oldVal = a;
+    a = ((cc.cy << 7) | (oldVal >> 1));
+    cc.cy = (oldVal & 1);
+    if constexpr (isZ80)
+        cc.ac = cc.n = 0;
+}
+
+/* Put the next instruction bits onto stack, jump to the specified location */
+template <class Policies>
+void Emulator8080<Policies>::call(uint16_t address) {
+    pushPair(pc + 3);
+    pc = address;
+}
+
+/* Jump to the memory specified by the stack pointer */
+template <class Policies>
+void Emulator8080<Policies>::ret() {
+    popPair(pc);
+}
+
+/* Put the next instruction bits onto stack, jump to the address at 8 times specified bits */
+template <class Policies>
+void Emulator8080<Policies>::rst(int nnn) {
+    pushPair(pc + 1);
+    pc = 8 * nnn;
+}
+
+/* Push the given register pair onto the stack, the high byte first, decrement stack pointer */
+template <class Policies>
+void Emulator8080<Policies>::pushPair(uint16_t pair) {
+    sp -= 2;
+    writeWord(sp, pair);
+}
+
+/* Push the A register and the Processor Status Word onto the stack, decrement stack pointer */
+template <class Policies>
+void Emulator8080<Policies>::pushPSW() {
+    writeMemory(sp - 1, a);
+    writeMemory(sp - 2, flagsByte());
+    sp -= 2;
+}
+
+/* Pop the memory pointed by stack pointer onto the register pair, increment the stack pointer */
+template <class Policies>
+void Emulator8080<Policies>::popPair(uint16_t& pair) {
+    pair = readWord(sp);
+    sp += 2;
+}
+
+/* Pop the memory pointed by stack pointer onto the flags and the A register,
+ * increment the stack pointer  */
+template <class Policies>
+void Emulator8080<Policies>::popPSW() {
+    setFlagsByte(readMemory(sp));
+    a = readMemory(sp + 1);
+    sp += 2;
+}
+
+/* The processor status word. Bit 1 is always set on the 8080, on the Z80 it holds N */
+template <class Policies>
+inline uint8_t Emulator8080<Policies>::flagsByte() const {
+    uint8_t fixed = isZ80 ? static_cast<uint8_t>(cc.n << 1) : 0x02;
+    return cc.cy | fixed | (cc.p << 2) | (cc.ac << 4) | (cc.z << 6) | (cc.s << 7);
+}
+
+template <class Policies>
+inline void Emulator8080<Policies>::setFlagsByte(uint8_t psw) {
+    cc.cy = (psw & 0x01);
+    cc.p = (psw >> 2) & 1;
+    cc.ac = (psw >> 4) & 1;
+    cc.z = (psw >> 6) & 1;
+    cc.s = (psw >> 7) & 1;
+    if constexpr (isZ80)
+        cc.n = (psw >> 1) & 1;
+}
+
+/* Exchange stack top with register H and L */
+template <class Policies>
+void Emulator8080<Policies>::xthl() {
+    uint16_t top = readWord(sp);
+    writeWord(sp, hl);
+    hl = top;
+}
+
+
+/* Address of the next instruction. While halted that is the one after the HLT, as on the 8080 */
+template <class Policies>
+uint16_t Emulator8080<Policies>::ProgramCounter() const {
+    return pc + halted;
+}
+
+/* Whether a HLT stopped the CPU. Only an interrupt gets it going again */
+template <class Policies>
+bool Emulator8080<Policies>::Halted() const {
+    return halted;
+}
+
+/* Address of the instruction the last run stopped at, when it stopped early */
+template <class Policies>
+uint16_t Emulator8080<Policies>::StopAddress() const {
+    return stopAddress;
+}
+
+template <class Policies>
+uint64_t Emulator8080<Policies>::Cycles() const {
+    return cycles;
+}
+
+/* Cycles charged for idle loop iterations that were never executed */
+template <class Policies>
+uint64_t Emulator8080<Policies>::SkippedCycles() const {
+    return skippedCycles;
+}
+
+/* Copy out the registers, the flags are normalized to 0 or 1 */
+template <class Policies>
+CpuState Emulator8080<Policies>::State() const {
+    CpuState state;
+    state.a = a;
+    state.b = b();
+    state.c = c();
+    state.d = d();
+    state.e = e();
+    state.h = h();
+    state.l = l();
+    state.sp = sp;
+    state.pc = pc + halted;
+    state.cc.z = cc.z != 0;
+    state.cc.s = cc.s != 0;
+    state.cc.p = cc.p != 0;
+    state.cc.cy = cc.cy != 0;
+    state.cc.ac = cc.ac != 0;
+    state.cc.n = cc.n != 0;
+    state.intEnable = intEnable;
+    state.halted = halted;
+    state.interruptMasks = interruptMasks;
+    state.ix = ix;
+    state.iy = iy;
+    state.af2 = af2;
+    state.bc2 = bc2;
+    state.de2 = de2;
+    state.hl2 = hl2;
+    state.i = interruptVector;
+    state.r = refreshCounter;
+    state.interruptMode = interruptMode;
+    state.iff2 = iff2;
+    return state;
+}
+
+/* Load the registers, the flags are normalized as the conditional instructions test for 1 */
+template <class Policies>
+void Emulator8080<Policies>::SetState(const CpuState& state) {
+    a = state.a;
+    bc = (state.b << 8) | state.c;
+    de = (state.d << 8) | state.e;
+    hl = (state.h << 8) | state.l;
+    sp = state.sp;
+    halted = state.halted != 0;
+    pc = state.pc - halted;
+    cc.z = state.cc.z != 0;
+    cc.s = state.cc.s != 0;
+    cc.p = state.cc.p != 0;
+    cc.cy = state.cc.cy != 0;
+    cc.ac = state.cc.ac != 0;
+    cc.n = state.cc.n != 0;
+    intEnable = state.intEnable;
+    interruptMasks = state.interruptMasks;
+    ix = state.ix;
+    iy = state.iy;
+    af2 = state.af2;
+    bc2 = state.bc2;
+    de2 = state.de2;
+    hl2 = state.hl2;
+    interruptVector = state.i;
+    refreshCounter = state.r;
+    interruptMode = state.interruptMode;
+    iff2 = state.iff2;
+    loopHead = 0x10000;
+}
+
+/* Move the clock, as when restoring a machine saved at another cycle */
+template <class Policies>
+void Emulator8080<Policies>::SetCycles(uint64_t count) {
+    cycles = count;
+    loopHead = 0x10000;
+}
+
+/* Execute instructions until the clock reaches the given cycle, or something stops the run first.
+ * The run resumed after a breakpoint executes the instruction under it instead of stopping again.
+ * A stop lowers the target the loop compares the clock with, so the loop itself tests nothing more */
+template <class Policies>
+StopReason Emulator8080<Policies>::RunUntil(uint64_t cycle) {
+    /* Stopped outside of the run loop, as by a watchpoint hit by the push of an interrupt */
+    if (stopReason != StopReason::None) {
+        StopReason reason = stopReason;
+        stopReason = StopReason::None;
+        return reason;
+    }
+    runTarget = cycle;
+
+    /* Skipped iterations would pass over the breakpoints and watchpoints inside the loop, and over
+     * the machine cycles the bus handler is waiting for */
+    bool skipping = idleSkip;
+    if constexpr (Policies::debug || Policies::watch)
+        skipping = skipping && !debugger;
+    if constexpr (Policies::busTiming)
+        skipping = skipping && !busHandler;
+
+    while (cycles < runTarget) {
+        /* The inputs are sampled after every instruction but the EI, so a handler ending in EI; RET
+         * returns before the next interrupt is taken */
+        if constexpr (is8085) {
+            if (interruptDelay)
+                interruptDelay = false;
+            else if ((interruptLines & (trapPending | rst65Pending | rst55Pending)) || (interruptMasks & rst75Pending))
+                acceptInterrupt();
+        }
+
+        if constexpr (Policies::debug) {
+            if (debugger && debugger->IsBreakpoint(pc) && pc != resumeAddress &&
+                debugger->Trigger(Debugger8080::Event::Breakpoint, pc, pc, memory[pc])) {
+                resumeAddress = pc;
+                stopAddress = pc;
+                return StopReason::Breakpoint;
+            }
+            resumeAddress = 0x10000;
+        }
+
+        if (skipping) {
+            uint16_t from = pc;
+            Emulate();
+            if (pc <= from && from - pc <= maxIdleLoop)
+                skipIdleLoop(from, runTarget);
+        }
+        else
+            Emulate();
+    }
+
+    StopReason reason = stopReason;
+    stopReason = StopReason::None;
+    return reason;
+}
+
+/* End the run after the current instruction, for the I/O handlers. The address reported is the
+ * one of the instruction executing, or of the next one when called between instructions */
+template <class Policies>
+void Emulator8080<Policies>::Stop(StopReason reason) {
+    stopReason = reason;
+    stopAddress = pc;
+    runTarget = 0;
+}
+
+/* Push the program counter and jump to the handler of the given RST number, if interrupts are on.
+ * A halted CPU resumes, returning from the handler to the instruction after the HLT. A Z80 in mode 1
+ * goes to RST 7 whatever the number, in mode 2 to the address in the table the I register points
+ * at, indexed by the RST opcode the device puts on the bus */
+template <class Policies>
+void Emulator8080<Policies>::GenerateInterrupt(int number) {
+    if (!intEnable)
+        return;
+
+    if constexpr (isZ80) {
+        iff2 = 0;
+        refresh();
+        if (interruptMode == 2) {
+            uint16_t entry = (interruptVector << 8) | 0xC7 | (number << 3);
+            interrupt(readMemory(entry) | (readMemory(entry + 1) << 8));
+            cycles += 6;
+            return;
+        }
+        if (interruptMode == 1)
+            number = 7;
+    }
+    interrupt(8 * number);
+}
+
+/* Z80 non-maskable interrupt, taken whatever the interrupt enable, which IFF2 keeps for RETN.
+ * Ignored by the 8080 and 8085 */
+template <class Policies>
+void Emulator8080<Policies>::GenerateNmi() {
+    if constexpr (isZ80) {
+        iff2 = intEnable;
+        refresh();
+        interrupt(0x66);
+        cycles -= 2;
+    }
+}
+
+/* Push the program counter and jump to the address, resuming a halted CPU after its HLT */
+template <class Policies>
+void Emulator8080<Policies>::interrupt(uint16_t address) {
+    if (halted) {
+        halted = false;
+        ++pc;
+    }
+
+    if constexpr (Policies::busTiming) {
+        busClock = cycles;
+        busCycle(BusCycle::InterruptAcknowledge, address, 0, fetchStates(0xC7));
+    }
+    pushPair(pc);
+    pc = address;
+    intEnable = 0;
+    cycles += is8085 ? 12 : isZ80 ? 13 : 11;
+}
+
+/* Read a port for the IN instructions. Without a device the accumulator is left as it was */
+template <class Policies>
+inline uint8_t Emulator8080<Policies>::input(uint8_t port) {
+    uint8_t value = a;
+    if (inputHandler)
+        value = inputHandler(ioContext, port);
+    ++sideEffects;
+    if constexpr (Policies::busTiming)
+        busCycle(BusCycle::Input, port, value, 3);
+    if constexpr (Policies::watch) {
+        if (debugger && debugger->IsPortInWatched(port))
+            watchHit(Debugger8080::Event::PortIn, port, value);
+    }
+    return value;
+}
+
+/* Write a port for the OUT instructions */
+template <class Policies>
+inline void Emulator8080<Policies>::output(uint8_t port, uint8_t value) {
+    if constexpr (Policies::busTiming)
+        busCycle(BusCycle::Output, port, value, 3);
+    if constexpr (Policies::watch) {
+        if (debugger && debugger->IsPortOutWatched(port))
+            watchHit(Debugger8080::Event::PortOut, port, value);
+    }
+    if (outputHandler)
+        outputHandler(ioContext, port, value);
+    ++sideEffects;
+}
+
+/* Drive an interrupt input of the 8085, taken by RunUntil before the next instruction. Ignored by the 8080 */
+template <class Policies>
+void Emulator8080<Policies>::SetInterruptLine(InterruptLine8085 line, bool level) {
+    switch (line) {
+        case InterruptLine8085::Rst55:
+            interruptLines = level ? interruptLines | rst55Pending : interruptLines & ~rst55Pending;
+            break;
+        case InterruptLine8085::Rst65:
+            interruptLines = level ? interruptLines | rst65Pending : interruptLines & ~rst65Pending;
+            break;
+        case InterruptLine8085::Rst75:
+            if (level)
+                interruptMasks |= rst75Pending;
+            break;
+        case InterruptLine8085::Trap:
+            if (level)
+                interruptLines |= trapPending;
+            break;
+    }
+}
+
+/* The SID pin of the 8085, read by RIM into bit 7 */
+template <class Policies>
+void Emulator8080<Policies>::SetSerialInput(bool level) {
+    interruptLines = level ? interruptLines | serialBit : interruptLines & ~serialBit;
+}
+
+/* The SOD pin of the 8085, written by SIM from bit 7 */
+template <class Policies>
+bool Emulator8080<Policies>::SerialOutput() const {
+    return interruptMasks & serialBit;
+}
+
+/* Take the pending 8085 interrupt of the highest priority: TRAP, then RST 7.5, 6.5 and 5.5.
+ * Only TRAP gets through a DI, the others also need their mask clear */
+template <class Policies>
+void Emulator8080<Policies>::acceptInterrupt() {
+    if (interruptLines & trapPending) {
+        interruptLines &= ~trapPending;
+        interrupt(0x24);
+        return;
+    }
+    if (!intEnable)
+        return;
+
+    if ((interruptMasks & rst75Pending) && !(interruptMasks & 0x04)) {
+        interruptMasks &= ~rst75Pending;
+        interrupt(0x3C);
+    }
+    else if ((interruptLines & rst65Pending) && !(interruptMasks & 0x02))
+        interrupt(0x34);
+    else if ((interruptLines & rst55Pending) && !(interruptMasks & 0x01))
+        interrupt(0x2C);
+}
+
+/* RIM: SID, the pending RST 7.5, 6.5 and 5.5, the interrupt enable and the three masks */
+template <class Policies>
+void Emulator8080<Policies>::readInterruptMask() {
+    a = (interruptLines & (serialBit | rst65Pending | rst55Pending)) | (interruptMasks & (rst75Pending | 0x07)) |
+        (intEnable ? 0x08 : 0);
+}
+
+/* SIM: bit 3 enables setting the masks from bits 0-2, bit 4 clears a pending RST 7.5,
+ * bit 6 enables setting SOD from bit 7 */
+template <class Policies>
+void Emulator8080<Policies>::setInterruptMask() {
+    if (a & 0x08)
+        interruptMasks = (interruptMasks & ~0x07) | (a & 0x07);
+    if (a & 0x10)
+        interruptMasks &= ~rst75Pending;
+    if (a & 0x40)
+        interruptMasks = (interruptMasks & ~serialBit) | (a & serialBit);
+}
+
+/* Set the devices called by the IN and OUT instructions */
+template <class Policies>
+void Emulator8080<Policies>::SetIOHandlers(InputHandler input, OutputHandler output, void* context) {
+    inputHandler = input;
+    outputHandler = output;
+    ioContext = context;
+}
+
+/* Set the device told of every machine cycle by the bus timing policy, nullptr turns it off */
+template <class Policies>
+void Emulator8080<Policies>::SetBusHandler(BusHandler handler, void* context) {
+    busHandler = handler;
+    busContext = context;
+}
+
+/* Disassemble every instruction to the given output, nullptr turns the trace off */
+template <class Policies>
+void Emulator8080<Policies>::SetTraceOutput(FILE* out) {
+    traceOutput = out;
+}
+
+template <class Policies>
+void Emulator8080<Policies>::SetProfiler(Profiler8080* instructionProfiler) {
+    profiler = instructionProfiler;
+}
+
+/* Stop on the undocumented opcodes instead of executing them as the instructions they alias.
+ * Real programs do not use them, running into one usually means running into data */
+template <class Policies>
+void Emulator8080<Policies>::SetStrictOpcodes(bool enabled) {
+    strictOpcodes = enabled;
+}
+
+/* Fast-forward through idle loops in RunUntil instead of executing them */
+template <class Policies>
+void Emulator8080<Policies>::SetIdleSkip(bool enabled) {
+    idleSkip = enabled;
+    loopHead = 0x10000;
+}
+
+/* Called after a backward jump was taken. A loop arriving at its head in the same state as on the
+ * previous arrival, without writing memory or doing I/O in between, reads the same memory every
+ * iteration and so spins until the next interrupt. Its iterations are charged without running them,
+ * stopping one short of the target cycle so the clock ends at the same instruction a full run would.
+ * A halted CPU is the simplest such loop, the HLT jumping to itself */
+template <class Policies>
+void Emulator8080<Policies>::skipIdleLoop(uint16_t from, uint64_t cycle) {
+    uint8_t opCode = memory[from];
+    if (halted) {
+        uint64_t skipped = cycles < cycle ? (cycle - cycles - 1) / 4 * 4 : 0;
+        cycles += skipped;
+        skippedCycles += skipped;
+        if constexpr (isZ80)
+            refreshCounter = (refreshCounter & 0x80) | ((refreshCounter + skipped / 4) & 0x7F);
+        return;
+    }
+    if constexpr (isZ80) {
+        if (opCode != 0xC3 && (opCode & 0xC7) != 0xC2 && opCode != 0x18 && (opCode & 0xE7) != 0x20)
+            return;
+    }
+    else if (opCode != 0xC3 && opCode != 0xCB && (opCode & 0xC7) != 0xC2)
+        return;
+
+    /* A counting loop never matches, so after a few misses its head is only looked at now and then */
+    uint8_t& misses = loopMisses[pc % 64];
+    if (misses >= 8 && ++misses != 0)
+        return;
+
+    uint64_t registers = registerSnapshot();
+    uint64_t status = statusSnapshot();
+    uint64_t index = 0;
+    uint64_t alternates = 0;
+    if constexpr (isZ80) {
+        index = indexSnapshot();
+        alternates = alternateSnapshot();
+    }
+    if (loopHead == pc) {
+        if (loopEffects == sideEffects && loopRegisters == registers && loopStatus == status &&
+            loopIndex == index && loopAlternates == alternates) {
+            uint64_t iteration = cycles - loopCycles;
+            if (iteration && cycles + iteration < cycle) {
+                uint64_t skipped = (cycle - cycles - 1) / iteration * iteration;
+                cycles += skipped;
+                skippedCycles += skipped;
+                /* R counts on through the skipped iterations, as many instructions each as this one */
+                if constexpr (isZ80) {
+                    uint8_t counted = (refreshCounter - loopRefresh) & 0x7F;
+                    uint8_t advance = static_cast<uint8_t>(skipped / iteration * counted);
+                    refreshCounter = (refreshCounter & 0x80) | ((refreshCounter + advance) & 0x7F);
+                }
+            }
+            misses = 0;
+        }
+        else
+            ++misses;
+    }
+
+    loopHead = pc;
+    loopEffects = sideEffects;
+    loopCycles = cycles;
+    loopRegisters = registers;
+    loopStatus = status;
+    loopIndex = index;
+    loopAlternates = alternates;
+    loopRefresh = refreshCounter;
+}
+
+/* The registers and the interrupt enable packed for comparing two loop iterations */
+template <class Policies>
+uint64_t Emulator8080<Policies>::registerSnapshot() const {
+    return static_cast<uint64_t>(a) | (static_cast<uint64_t>(bc) << 8) | (static_cast<uint64_t>(de) << 24) |
+           (static_cast<uint64_t>(hl) << 40) | (static_cast<uint64_t>(intEnable) << 56);
+}
+
+/* The flags, a byte each, and the stack pointer */
+template <class Policies>
+uint64_t Emulator8080<Policies>::statusSnapshot() const {
+    return static_cast<uint64_t>(cc.cy) | (static_cast<uint64_t>(cc.p) << 8) | (static_cast<uint64_t>(cc.ac) << 16) |
+           (static_cast<uint64_t>(cc.z) << 24) | (static_cast<uint64_t>(cc.s) << 32) | (static_cast<uint64_t>(sp) << 40) |
+           (static_cast<uint64_t>(cc.n) << 56);
+}
+
+/* Z80: the index registers, the alternate AF and BC */
+template <class Policies>
+uint64_t Emulator8080<Policies>::indexSnapshot() const {
+    return static_cast<uint64_t>(ix) | (static_cast<uint64_t>(iy) << 16) | (static_cast<uint64_t>(af2) << 32) |
+           (static_cast<uint64_t>(bc2) << 48);
+}
+
+/* Z80: the alternate DE and HL, I, the interrupt mode and IFF2 */
+template <class Policies>
+uint64_t Emulator8080<Policies>::alternateSnapshot() const {
+    return static_cast<uint64_t>(de2) | (static_cast<uint64_t>(hl2) << 16) |
+           (static_cast<uint64_t>(interruptVector) << 32) | (static_cast<uint64_t>(interruptMode) << 40) |
+           (static_cast<uint64_t>(iff2) << 48);
+}
+
+/* Set the breakpoints and watchpoints checked by the debug and watch policies, nullptr turns them off */
+template <class Policies>
+void Emulator8080<Policies>::SetDebugger(Debugger8080* instructionDebugger) {
+    debugger = instructionDebugger;
+    resumeAddress = 0x10000;
+}
+
+/* Execute one instruction, passing it through the hooks enabled by the policies */
+template <class Policies>
+void Emulator8080<Policies>::Emulate() {
+    if constexpr (Policies::trace) {
+        if (traceOutput)
+            disassembler(memory, pc, traceOutput);
+    }
+
+    if constexpr (Policies::profile) {
+        if (profiler) {
+            uint16_t address = pc;
+            uint16_t stack = sp;
+            uint8_t opCode = memory[pc];
+            uint64_t start = cycles;
+
+            execute();
+            profiler->Record(address, opCode, static_cast<uint32_t>(cycles - start), pc, stack, sp);
+            return;
+        }
+    }
+
+    execute();
+}
+
+/* Emulate the 8080 using saved memory buffer. Every opcode has its case, the undocumented ones
+ * behave as the documented instructions they alias. The Z80 takes its own instructions over the
+ * undocumented opcodes, the prefixes leading to the second-level tables of Z80Prefixed.inl */
+template <class Policies>
+void Emulator8080<Policies>::execute() {
+    unsigned char* opCode = instructionBytes();
+    if constexpr (Policies::busTiming)
+        fetchCycles(opCode);
+    cycles += opCycles(*opCode);
+    if constexpr (isZ80)
+        refresh();
+
+    switch (*opCode) {
+        case 0x20: /* RIM on the 8085, JR NZ on the Z80 */
+            if constexpr (isZ80) {
+                jumpRelative(cc.z == 0);
+                return;
+            }
+            else if constexpr (is8085) {
+                readInterruptMask();
+                break;
+            }
+            [[fallthrough]];
+        case 0x30: /* SIM on the 8085, JR NC on the Z80 */
+            if constexpr (isZ80) {
+                jumpRelative(cc.cy == 0);
+                return;
+            }
+            else if constexpr (is8085) {
+                setInterruptMask();
+                break;
+            }
+            [[fallthrough]];
+        case 0x08: /* EX AF, AF' on the Z80 */
+            if constexpr (isZ80) {
+                exchangeAF();
+                break;
+            }
+            [[fallthrough]];
+        case 0x10: /* DJNZ on the Z80 */
+            if constexpr (isZ80) {
+                setB(b() - 1);
+                jumpRelative(b() != 0);
+                return;
+            }
+            [[fallthrough]];
+        case 0x18: /* JR on the Z80 */
+            if constexpr (isZ80) {
+                jumpRelative(true);
+                return;
+            }
+            [[fallthrough]];
+        case 0x28: /* JR Z on the Z80 */
+            if constexpr (isZ80) {
+                jumpRelative(cc.z == 1);
+                return;
+            }
+            [[fallthrough]];
+        case 0x38: /* JR C on the Z80, otherwise undocumented NOP like the above */
+            if constexpr (isZ80) {
+                jumpRelative(cc.cy == 1);
+                return;
+            }
+            if (strictOpcodes) {
+                illegalOpcode();
+                return;
+            }
+            break;
+        case 0x00: /* NOP */
+            break;
+
+        case 0x01: /* LXI B, d16 */
+            bc = wordAt(opCode + 1);
+            pc += 2;
+            break;
+        case 0x02: /* STAX B */
+            writeMemory(bc, a);
+            break;
+        case 0x03: /* INX B */
+            ++bc;
+            break;
+        case 0x04: /* INR B */
+            setB(incrementRegister(b()));
+            break;
+        case 0x05: /* DCR B */
+            setB(decrementRegister(b()));
+            break;
+        case 0x06: /* MVI B, d8 */
+            setB(opCode[1]);
+            ++pc;
+            break;
+        case 0x07: /* RLC */
+            rotateLeft();
+            break;
+        case 0x09: /* DAD B */
+            addPairToHL(bc);
+            break;
+        case 0x0A: /* LDAX B */
+            a = readMemory(bc);
+            break;
+        case 0x0B: /* DCX B */
+            --bc;
+            break;
+        case 0x0C: /* INR C */
+            setC(incrementRegister(c()));
+            break;
+        case 0x0D: /* DCR C */
+            setC(decrementRegister(c()));
+            break;
+        case 0x0E: /* MVI C, d8 */
+            setC(opCode[1]);
+            ++pc;
+            break;
+        case 0x0F: /* RRC */
+            rotateRight();
+            break;
+
+
+        case 0x11: /* LXI D, d16 */
+            de = wordAt(opCode + 1);
+            pc += 2;
+            break;
+        case 0x12: /* STAX D */
+            writeMemory(de, a);
+            break;
+        case 0x13: /* INX D */
+            ++de;
+            break;
+        case 0x14: /* INR D */
+            setD(incrementRegister(d()));
+            break;
+        case 0x15: /* DCR D */
+            setD(decrementRegister(d()));
+            break;
+        case 0x16: /* MVI D, d8 */
+            setD(opCode[1]);
+            ++pc;
+            break;
+        case 0x17: /* RAL */
+            rotateLeftCarry();
+            break;
+        case 0x19: /* DAD D */
+            addPairToHL(de);
+            break;
+        case 0x1A: /* LDAX D */
+            a = readMemory(de);
+            break;
+        case 0x1B: /* DCX D */
+            --de;
+            break;
+        case 0x1C: /* INR E */
+            setE(incrementRegister(e()));
+            break;
+        case 0x1D: /* DCR E */
+            setE(decrementRegister(e()));
+            break;
+        case 0x1E: /* MVI E, d8 */
+            setE(opCode[1]);
+            ++pc;
+            break;
+        case 0x1F: /* RAR */
+            rotateRightCarry();
+            break;
+
+
+        case 0x21: /* LXI H, d16 */
+            hl = wordAt(opCode + 1);
+            pc += 2;
+            break;
+        case 0x22: /* SHLD addr */
+            writeWord(wordAt(opCode + 1), hl);
+            pc += 2;
+            break;
+        case 0x23: /* INX H */
+            ++hl;
+            break;
+        case 0x24: /* INR H */
+            setH(incrementRegister(h()));
+            break;
+        case 0x25: /* DCR H */
+            setH(decrementRegister(h()));
+            break;
+        case 0x26: /* MVI H, d8 */
+            setH(opCode[1]);
+            ++pc;
+            break;
+        case 0x27: /* DAA */
+            decimalAdjustAcc();
+            break;
+        case 0x29: /* DAD H */
+            addPairToHL(hl);
+            break;
+        case 0x2A: /* LHLD addr */
+            hl = readWord(wordAt(opCode + 1));
+            pc += 2;
+            break;
+        case 0x2B: /* DCX H */
+            --hl;
+            break;
+        case 0x2C: /* INR L */
+            setL(incrementRegister(l()));
+            break;
+        case 0x2D: /* DCR L */
+            setL(decrementRegister(l()));
+            break;
+        case 0x2E: /* MVI L, d8 */
+            setL(opCode[1]);
+            ++pc;
+            break;
+        case 0x2F: /* CMA */
+            a = ~a;
+            if constexpr (isZ80)
+                cc.ac = cc.n = 1;
+            break;
+
+
+        case 0x31: /* LXI SP, d16 */
+            sp = wordAt(opCode + 1);
+            pc += 2;
+            break;
+        case 0x32: /* STA addr */
+            writeMemory(wordAt(opCode + 1), a);
+            pc += 2;
+            break;
+        case 0x33: /* INX SP */
+            ++sp;
+            break;
+        case 0x34: /* INR M */
+            incrementMemory(hl);
+            break;
+        case 0x35: /* DCR M */
+            decrementMemory(hl);
+            break;
+        case 0x36: /* MVI M, d8 */
+            writeMemory(hl, opCode[1]);
+            ++pc;
+            break;
+        case 0x37: /* STC */
+            cc.cy = 1;
+            if constexpr (isZ80)
+                cc.ac = cc.n = 0;
+            break;
+        case 0x39: /* DAD SP */
+            addPairToHL(sp);
+            break;
+        case 0x3A: /* LDA addr */
+            a = readMemory(wordAt(opCode + 1));
+            pc += 2;
+            break;
+        case 0x3B: /* DCX SP */
+            --sp;
+            break;
+        case 0x3C: /* INR A */
+            a = incrementRegister(a);
+            break;
+        case 0x3D: /* DCR A */
+            a = decrementRegister(a);
+            break;
+        case 0x3E: /* MVI A, d8 */
+            a = opCode[1];
+            ++pc;
+            break;
+        case 0x3F: /* CMC */
+            if constexpr (isZ80) {
+                cc.ac = cc.cy;
+                cc.n = 0;
+            }
+            cc.cy ^= 1;
+            break;
+
+
+        case 0x40: /* MOV B, B */
+            break;
+        case 0x41: /* MOV B, C */
+            setB(c());
+            break;
+        case 0x42: /* MOV B, D */
+            setB(d());
+            break;
+        case 0x43: /* MOV B, E */
+            setB(e());
+            break;
+        case 0x44: /* MOV B, H */
+            setB(h());
+            break;
+        case 0x45: /* MOV B, L */
+            setB(l());
+            break;
+        case 0x46: /* MOV B, M */
+            setB(readMemory(hl));
+            break;
+        case 0x47: /* MOV B, A */
+            setB(a);
+            break;
+        case 0x48: /* MOV C, B */
+            setC(b());
+            break;
+        case 0x49: /* MOV C, C */
+            break;
+        case 0x4A: /* MOV C, D */
+            setC(d());
+            break;
+        case 0x4B: /* MOV C, E */
+            setC(e());
+            break;
+        case 0x4C: /* MOV C, H */
+            setC(h());
+            break;
+        case 0x4D: /* MOV C, L */
+            setC(l());
+            break;
+        case 0x4E: /* MOV C, M */
+            setC(readMemory(hl));
+            break;
+        case 0x4F: /* MOV C, A */
+            setC(a);
+            break;
+
+
+        case 0x50: /* MOV D, B */
+            setD(b());
+            break;
+        case 0x51: /* MOV D, C */
+            setD(c());
+            break;
+        case 0x52: /* MOV D, D */
+            break;
+        case 0x53: /* MOV D, E */
+            setD(e());
+            break;
+        case 0x54: /* MOV D, H */
+            setD(h());
+            break;
+        case 0x55: /* MOV D, L */
+            setD(l());
+            break;
+        case 0x56: /* MOV D, M */
+            setD(readMemory(hl));
+            break;
+        case 0x57: /* MOV D, A */
+            setD(a);
+            break;
+        case 0x58: /* MOV E, B */
+            setE(b());
+            break;
+        case 0x59: /* MOV E, C */
+            setE(c());
+            break;
+        case 0x5A: /* MOV E, D */
+            setE(d());
+            break;
+        case 0x5B: /* MOV E, E */
+            break;
+        case 0x5C: /* MOV E, H */
+            setE(h());
+            break;
+        case 0x5D: /* MOV E, L */
+            setE(l());
+            break;
+        case 0x5E: /* MOV E, M */
+            setE(readMemory(hl));
+            break;
+        case 0x5F: /* MOV E, A */
+            setE(a);
+            break;
+
+
+        case 0x60: /* MOV H, B */
+            setH(b());
+            break;
+        case 0x61: /* MOV H, C */
+            setH(c());
+            break;
+        case 0x62: /* MOV H, D */
+            setH(d());
+            break;
+        case 0x63: /* MOV H, E */
+            setH(e());
+            break;
+        case 0x64: /* MOV H, H */
+            break;
+        case 0x65: /* MOV H, L */
+            setH(l());
+            break;
+        case 0x66: /* MOV H, M */
+            setH(readMemory(hl));
+            break;
+        case 0x67: /* MOV H, A */
+            setH(a);
+            break;
+        case 0x68: /* MOV L, B */
+            setL(b());
+            break;
+        case 0x69: /* MOV L, C */
+            setL(c());
+            break;
+        case 0x6A: /* MOV L, D */
+            setL(d());
+            break;
+        case 0x6B: /* MOV L, E */
+            setL(e());
+            break;
+        case 0x6C: /* MOV L, H */
+            setL(h());
+            break;
+        case 0x6D: /* MOV L, L */
+            break;
+        case 0x6E: /* MOV L, M */
+            setL(readMemory(hl));
+            break;
+        case 0x6F: /* MOV L, A */
+            setL(a);
+            break;
+
+
+        case 0x70: /* MOV M, B */
+            writeMemory(hl, b());
+            break;
+        case 0x71: /* MOV M, C */
+            writeMemory(hl, c());
+            break;
+        case 0x72: /* MOV M, D */
+            writeMemory(hl, d());
+            break;
+        case 0x73: /* MOV M, E */
+            writeMemory(hl, e());
+            break;
+        case 0x74: /* MOV M, H */
+            writeMemory(hl, h());
+            break;
+        case 0x75: /* MOV M, L */
+            writeMemory(hl, l());
+            break;
+        case 0x76: /* HLT */
+            /* The program counter stays on the HLT, executing it again is the halted state.
+             * The first time takes the states of the table, every one after that 4 */
+            if (halted)
+                cycles -= opCycles(0x76) - 4;
+            halted = true;
+            if (!intEnable)
+                Stop(StopReason::Halt);
+            return;
+        case 0x77: /* MOV M, A */
+            writeMemory(hl, a);
+            break;
+        case 0x78: /* MOV A, B */
+            a = b();
+            break;
+        case 0x79: /* MOV A, C */
+            a = c();
+            break;
+        case 0x7A: /* MOV A, D */
+            a = d();
+            break;
+        case 0x7B: /* MOV A, E */
+            a = e();
+            break;
+        case 0x7C: /* MOV A, H */
+            a = h();
+            break;
+        case 0x7D: /* MOV A, L */
+            a = l();
+            break;
+        case 0x7E: /* MOV A, M */
+            a = readMemory(hl);
+            break;
+        case 0x7F: /* MOV A, A */
+            break;
+
+
+        case 0x80: /* ADD B */
+            addRegister(b());
+            break;
+        case 0x81: /* ADD C */
+            addRegister(c());
+            break;
+        case 0x82: /* ADD D */
+            addRegister(d());
+            break;
+        case 0x83: /* ADD E */
+            addRegister(e());
+            break;
+        case 0x84: /* ADD H */
+            addRegister(h());
+            break;
+        case 0x85: /* ADD L */
+            addRegister(l());
+            break;
+        case 0x86: /* ADD M */
+            addRegister(readMemory(hl));
+            break;
+        case 0x87: /* ADD A */
+            addRegister(a);
+            break;
+        case 0x88: /* ADC B */
+            addRegisterCarry(b());
+            break;
+        case 0x89: /* ADC C */
+            addRegisterCarry(c());
+            break;
+        case 0x8A: /* ADC D */
+            addRegisterCarry(d());
+            break;
+        case 0x8B: /* ADC E */
+            addRegisterCarry(e());
+            break;
+        case 0x8C: /* ADC H */
+            addRegisterCarry(h());
+            break;
+        case 0x8D: /* ADC L */
+            addRegisterCarry(l());
+            break;
+        case 0x8E: /* ADC M */
+            addRegisterCarry(readMemory(hl));
+            break;
+        case 0x8F: /* ADC A */
+            addRegisterCarry(a);
+            break;
+
+
+        case 0x90: /* SUB B */
+            subtractRegister(b());
+            break;
+        case 0x91: /* SUB C */
+            subtractRegister(c());
+            break;
+        case 0x92: /* SUB D */
+            subtractRegister(d());
+            break;
+        case 0x93: /* SUB E */
+            subtractRegister(e());
+            break;
+        case 0x94: /* SUB H */
+            subtractRegister(h());
+            break;
+        case 0x95: /* SUB L */
+            subtractRegister(l());
+            break;
+        case 0x96: /* SUB M */
+            subtractRegister(readMemory(hl));
+            break;
+        case 0x97: /* SUB A */
+            subtractRegister(a);
+            break;
+        case 0x98: /* SBB B */
+            subtractRegisterBorrow(b());
+            break;
+        case 0x99: /* SBB C */
+            subtractRegisterBorrow(c());
+            break;
+        case 0x9A: /* SBB D */
+            subtractRegisterBorrow(d());
+            break;
+        case 0x9B: /* SBB E */
+            subtractRegisterBorrow(e());
+            break;
+        case 0x9C: /* SBB H */
+            subtractRegisterBorrow(h());
+            break;
+        case 0x9D: /* SBB L */
+            subtractRegisterBorrow(l());
+            break;
+        case 0x9E: /* SBB M */
+            subtractRegisterBorrow(readMemory(hl));
+            break;
+        case 0x9F: /* SBB A */
+            subtractRegisterBorrow(a);
+            break;
+
+
+        case 0xA0: /* ANA B */
+            logicalAndRegister(b());
+            break;
+        case 0xA1: /* ANA C */
+            logicalAndRegister(c());
+            break;
+        case 0xA2: /* ANA D */
+            logicalAndRegister(d());
+            break;
+        case 0xA3: /* ANA E */
+            logicalAndRegister(e());
+            break;
+        case 0xA4: /* ANA H */
+            logicalAndRegister(h());
+            break;
+        case 0xA5: /* ANA L */
+            logicalAndRegister(l());
+            break;
+        case 0xA6: /* ANA M */
+            logicalAndRegister(readMemory(hl));
+            break;
+        case 0xA7: /* ANA A */
+            logicalAndRegister(a);
+            break;
+        case 0xA8: /* XRA B */
+            logicalXOrRegister(b());
+            break;
+        case 0xA9: /* XRA C */
+            logicalXOrRegister(c());
+            break;
+        case 0xAA: /* XRA D */
+            logicalXOrRegister(d());
+            break;
+        case 0xAB: /* XRA E */
+            logicalXOrRegister(e());
+            break;
+        case 0xAC: /* XRA H */
+            logicalXOrRegister(h());
+            break;
+        case 0xAD: /* XRA L */
+            logicalXOrRegister(l());
+            break;
+        case 0xAE: /* XRA M */
+            logicalXOrRegister(readMemory(hl));
+            break;
+        case 0xAF: /* XRA A */
+            logicalXOrRegister(a);
+            break;
+
+
+        case 0xB0: /* ORA B */
+            logicalOrRegister(b());
+            break;
+        case 0xB1: /* ORA C */
+            logicalOrRegister(c());
+            break;
+        case 0xB2: /* ORA D */
+            logicalOrRegister(d());
+            break;
+        case 0xB3: /* ORA E */
+            logicalOrRegister(e());
+            break;
+        case 0xB4: /* ORA H */
+            logicalOrRegister(h());
+            break;
+        case 0xB5: /* ORA L */
+            logicalOrRegister(l());
+            break;
+        case 0xB6: /* ORA M */
+            logicalOrRegister(readMemory(hl));
+            break;
+        case 0xB7: /* ORA A */
+            logicalOrRegister(a);
+            break;
+        case 0xB8: /* CMP B */
+            compareRegister(b());
+            break;
+        case 0xB9: /* CMP C */
+            compareRegister(c());
+            break;
+        case 0xBA: /* CMP D */
+            compareRegister(d());
+            break;
+        case 0xBB: /* CMP E */
+            compareRegister(e());
+            break;
+        case 0xBC: /* CMP H */
+            compareRegister(h());
+            break;
+        case 0xBD: /* CMP L */
+            compareRegister(l());
+            break;
+        case 0xBE: /* CMP M */
+            compareRegister(readMemory(hl));
+            break;
+        case 0xBF: /* CMP A */
+            compareRegister(a);
+            break;
+
+
+        case 0xC0: /* RNZ */
+            if (cc.z == 0) {
+                cycles += returnTaken;
+                ret();
+                return;
+            }
+            break;
+        case 0xC1: /* POP B */
+            popPair(bc);
+            break;
+        case 0xC2: /* JNZ, addr */
+            if (cc.z == 0) {
+                cycles += jumpTaken;
+                pc = wordAt(opCode + 1);
+                return;
+            }
+            else
+                pc += 2;
+            break;
+
+        case 0xCB: /* Undocumented JMP, addr, the CB prefix on the Z80 */
+            if constexpr (isZ80) {
+                executeCB();
+                return;
+            }
+            if (strictOpcodes) {
+                illegalOpcode();
+                return;
+            }
+            [[fallthrough]];
+        case 0xC3: /* JMP, addr */
+            pc = wordAt(opCode + 1);
+            return;
+
+        case 0xC4: /* CNZ, addr */
+            if (cc.z == 0) {
+                cycles += callTaken;
+                call(wordAt(opCode + 1));
+                return;
+            }
+            else
+                pc += 2;
+            break;
+        case 0xC5: /* PUSH B */
+            pushPair(bc);
+            break;
+        case 0xC6: /* ADI, d8 */
+            addRegister(opCode[1]);
+            ++pc;
+            break;
+        case 0xC7: /* RST 0 */
+            rst(0);
+            return;
+        case 0xC8: /* RZ */
+            if (cc.z == 1) {
+                cycles += returnTaken;
+                ret();
+                return;
+            }
+            break;
+
+        case 0xD9: /* Undocumented RET, EXX on the Z80 */
+            if constexpr (isZ80) {
+                exchangeRegisters();
+                break;
+            }
+            if (strictOpcodes) {
+                illegalOpcode();
+                return;
+            }
+            [[fallthrough]];
+        case 0xC9: /* RET */
+            ret();
+            return;
+
+        case 0xCA: /* JZ, addr */
+            if (cc.z == 1) {
+                cycles += jumpTaken;
+                pc = wordAt(opCode + 1);
+                return;
+            }
+            else
+                pc += 2;
+            break;
+        case 0xCC: /* CZ, addr */
+            if (cc.z == 1) {
+                cycles += callTaken;
+                call(wordAt(opCode + 1));
+                return;
+            }
+            else
+                pc += 2;
+            break;
+
+        /* Undocumented CALL, addr, the DD, ED and FD prefixes on the Z80. An index prefix before an
+         * instruction that does not use HL only costs its 4 states, the instruction runs next on its own */
+        case 0xDD:
+            if constexpr (isZ80) {
+                if (!executeIndexed(ix))
+                    break;
+                return;
+            }
+            [[fallthrough]];
+        case 0xFD:
+            if constexpr (isZ80) {
+                if (!executeIndexed(iy))
+                    break;
+                return;
+            }
+            [[fallthrough]];
+        case 0xED:
+            if constexpr (isZ80) {
+                executeED();
+                return;
+            }
+            if (strictOpcodes) {
+                illegalOpcode();
+                return;
+            }
+            [[fallthrough]];
+        case 0xCD: /* CALL, addr */
+            call(wordAt(opCode + 1));
+            return;
+
+        case 0xCE: /* ACI, d8 */
+            addRegisterCarry(opCode[1]);
+            ++pc;
+            break;
+        case 0xCF: /* RST 1 */
+            rst(1);
+            return;
+
+
+        case 0xD0: /* RNC */
+            if (cc.cy == 0) {
+                cycles += returnTaken;
+                ret();
+                return;
+            }
+            break;
+        case 0xD1: /* POP D */
+            popPair(de);
+            break;
+        case 0xD2: /* JNC, addr */
+            if (cc.cy == 0) {
+                cycles += jumpTaken;
+                pc = wordAt(opCode + 1);
+                return;
+            }
+            else
+                pc += 2;
+            break;
+
+        case 0xD3: /* OUT, d8 */
+            output(opCode[1], a);
+            ++pc;
+            break;
+
+        case 0xD4:  /* CNC, addr */
+            if (cc.cy == 0) {
+                cycles += callTaken;
+                call(wordAt(opCode + 1));
+                return;
+            }
+            else
+                pc += 2;
+            break;
+        case 0xD5: /* PUSH D */
+            pushPair(de);
+            break;
+        case 0xD6: /* SUI, d8 */
+            subtractRegister(opCode[1]);
+            ++pc;
+            break;
+        case 0xD7: /* RST 2 */
+            rst(2);
+            return;
+        case 0xD8: /* RC */
+            if (cc.cy == 1) {
+                cycles += returnTaken;
+                ret();
+                return;
+            }
+            break;
+        case 0xDA: /* JC, addr */
+            if (cc.cy == 1) {
+                cycles += jumpTaken;
+                pc = wordAt(opCode + 1);
+                return;
+            }
+            else
+                pc += 2;
+            break;
+        case 0xDB: /* IN, d8 */
+            a = input(opCode[1]);
+            ++pc;
+            break;
+        case 0xDC:  /* CC, addr */
+            if (cc.cy == 1) {
+                cycles += callTaken;
+                call(wordAt(opCode + 1));
+                return;
+            }
+            else
+                pc += 2;
+            break;
+        case 0xDE: /* SBI, d8 */
+            subtractRegisterBorrow(opCode[1]);
+            ++pc;
+            break;
+        case 0xDF: /* RST 3 */
+            rst(3);
+            return;
+
+
+        case 0xE0: /* RPO */
+            if (cc.p == 0) {
+                cycles += returnTaken;
+                ret();
+                return;
+            }
+            break;
+        case 0xE1: /* POP H */
+            popPair(hl);
+            break;
+        case 0xE2: /* JPO, addr */
+            if (cc.p == 0) {
+                cycles += jumpTaken;
+                pc = wordAt(opCode + 1);
+                return;
+            }
+            else
+                pc += 2;
+            break;
+        case 0xE3: /* XTHL */
+            xthl();
+            break;
+        case 0xE4: /* CPO, addr */
+            if (cc.p == 0) {
+                cycles += callTaken;
+                call(wordAt(opCode + 1));
+                return;
+            }
+            else
+                pc += 2;
+            break;
+        case 0xE5: /* PUSH H */
+            pushPair(hl);
+            break;
+        case 0xE6: /* ANI, d8 */
+            logicalAndRegister(opCode[1]);
+            ++pc;
+            break;
+        case 0xE7: /* RST 4 */
+            rst(4);
+            return;
+        case 0xE8: /* RPE */
+            if (cc.p == 1) {
+                cycles += returnTaken;
+                ret();
+                return;
+            }
+            break;
+        case 0xE9: /* PCHL */
+            pc = hl;
+            return;
+        case 0xEA: /* JPE, addr */
+            if (cc.p == 1) {
+                cycles += jumpTaken;
+                pc = wordAt(opCode + 1);
+                return;
+            }
+            else
+                pc += 2;
+            break;
+        case 0xEB: /* XCHG */
+            std::swap(hl, de);
+            break;
+        case 0xEC: /* CPE, addr */
+            if (cc.p == 1) {
+                cycles += callTaken;
+                call(wordAt(opCode + 1));
+                return;
+            }
+            else
+                pc += 2;
+            break;
+        case 0xEE: /* XRI, d8 */
+            logicalXOrRegister(opCode[1]);
+            ++pc;
+            break;
+        case 0xEF: /* RST 5 */
+            rst(5);
+            return;
+
+
+        case 0xF0: /* RP */
+            if (cc.s == 0) {
+                cycles += returnTaken;
+                ret();
+                return;
+            }
+            break;
+        case 0xF1: /* POP PSW */
+            popPSW();
+            break;
+        case 0xF2: /* JP, addr */
+            if (cc.s == 0) {
+                cycles += jumpTaken;
+                pc = wordAt(opCode + 1);
+                return;
+            }
+            else
+                pc += 2;
+            break;
+        case 0xF3: /* DI */
+            intEnable = 0;
+            if constexpr (isZ80)
+                iff2 = 0;
+            break;
+        case 0xF4: /* CP, addr */
+            if (cc.s == 0) {
+                cycles += callTaken;
+                call(wordAt(opCode + 1));
+                return;
+            }
+            else
+                pc += 2;
+            break;
+        case 0xF5: /* PUSH PSW */
+            pushPSW();
+            break;
+        case 0xF6: /* ORI, d8 */
+            logicalOrRegister(opCode[1]);
+            ++pc;
+            break;
+        case 0xF7: /* RST 6 */
+            rst(6);
+            return;
+        case 0xF8: /* RM */
+            if (cc.s == 1) {
+                cycles += returnTaken;
+                ret();
+                return;
+            }
+            break;
+        case 0xF9: /* SPHL */
+            sp = hl;
+            break;
+        case 0xFA: /* JM, addr */
+            if (cc.s == 1) {
+                cycles += jumpTaken;
+                pc = wordAt(opCode + 1);
+                return;
+            }
+            else
+                pc += 2;
+            break;
+        case 0xFB: /* EI */
+            intEnable = 1;
+            if constexpr (is8085)
+                interruptDelay = true;
+            if constexpr (isZ80)
+                iff2 = 1;
+            break;
+        case 0xFC: /* CM, addr */
+            if (cc.s == 1) {
+                cycles += callTaken;
+                call(wordAt(opCode + 1));
+                return;
+            }
+            else
+                pc += 2;
+            break;
+        case 0xFE: /* CPI, d8 */
+            compareRegister(opCode[1]);
+            ++pc;
+            break;
+        case 0xFF: /* RST 7 */
+            rst(7);
+            return;
+    }
+
+    ++pc;
+}
\ No newline at end of file
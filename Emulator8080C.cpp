@@ -0,0 +1,205 @@
+#include "Emulator8080C.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+#include "Emulator8080.h"
+
+
+static_assert(I8080_STOP_NONE == static_cast<int>(StopReason::None) &&
+              I8080_STOP_HALT == static_cast<int>(StopReason::Halt) &&
+              I8080_STOP_ILLEGAL_OPCODE == static_cast<int>(StopReason::IllegalOpcode) &&
+              I8080_STOP_FAULT == static_cast<int>(StopReason::Fault), "stop reasons differ from the core");
+
+namespace {
+    constexpr uint32_t stateMagic = 0x53303838;    /* "880S" */
+
+    /* Layout of a saved state, private to the library so it may change with the ABI version */
+    struct SavedState
+    {
+        uint32_t magic;
+        uint32_t version;
+        I8080Registers registers;
+        uint64_t cycles;
+        uint8_t memory[0x10000];
+    };
+
+    I8080Registers toRegisters(const CpuState& state) {
+        I8080Registers registers {};
+        registers.a = state.a;
+        registers.b = state.b;
+        registers.c = state.c;
+        registers.d = state.d;
+        registers.e = state.e;
+        registers.h = state.h;
+        registers.l = state.l;
+        registers.flags = static_cast<uint8_t>(state.cc.s << 7 | state.cc.z << 6 | state.cc.ac << 4 |
+                                               state.cc.p << 2 | 0x02 | state.cc.cy);
+        registers.sp = state.sp;
+        registers.pc = state.pc;
+        registers.interrupts_enabled = state.intEnable != 0;
+        registers.halted = state.halted != 0;
+        return registers;
+    }
+
+    CpuState toState(const I8080Registers& registers) {
+        CpuState state;
+        state.a = registers.a;
+        state.b = registers.b;
+        state.c = registers.c;
+        state.d = registers.d;
+        state.e = registers.e;
+        state.h = registers.h;
+        state.l = registers.l;
+        state.cc.s = (registers.flags >> 7) & 1;
+        state.cc.z = (registers.flags >> 6) & 1;
+        state.cc.ac = (registers.flags >> 4) & 1;
+        state.cc.p = (registers.flags >> 2) & 1;
+        state.cc.cy = registers.flags & 1;
+        state.sp = registers.sp;
+        state.pc = registers.pc;
+        state.intEnable = registers.interrupts_enabled != 0;
+        state.halted = registers.halted != 0;
+        return state;
+    }
+}
+
+
+struct I8080Cpu
+{
+    I8080Cpu() : memory(), cpu(memory), lastStop(StopReason::None)
+    { }
+
+    uint8_t memory[0x10000];
+    Emulator8080<> cpu;
+    StopReason lastStop;
+};
+
+uint32_t i8080_abi_version(void) {
+    return I8080_ABI_VERSION;
+}
+
+/* No exception may leave the library, a failed allocation returns NULL */
+I8080Cpu* i8080_create(void) {
+    try {
+        return new I8080Cpu();
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+
+void i8080_destroy(I8080Cpu* cpu) {
+    delete cpu;
+}
+
+long i8080_load_rom(I8080Cpu* cpu, const char* path, uint16_t address) {
+    FILE* file = fopen(path, "rb");
+    if (!file)
+        return -1;
+
+    size_t size = fread(cpu->memory + address, 1, 0x10000 - address, file);
+    fclose(file);
+    return static_cast<long>(size);
+}
+
+size_t i8080_load_buffer(I8080Cpu* cpu, const uint8_t* data, size_t size, uint16_t address) {
+    size = std::min<size_t>(size, 0x10000 - address);
+    memcpy(cpu->memory + address, data, size);
+    return size;
+}
+
+uint64_t i8080_run(I8080Cpu* cpu, uint64_t cycles) {
+    uint64_t start = cpu->cpu.Cycles();
+    cpu->lastStop = cpu->cpu.RunUntil(start + cycles);
+    return cpu->cpu.Cycles() - start;
+}
+
+int i8080_stop_reason(const I8080Cpu* cpu, uint16_t* address) {
+    if (address)
+        *address = cpu->cpu.StopAddress();
+    return static_cast<int>(cpu->lastStop);
+}
+
+void i8080_fault(I8080Cpu* cpu) {
+    cpu->cpu.Stop(StopReason::Fault);
+}
+
+void i8080_set_strict_opcodes(I8080Cpu* cpu, int enabled) {
+    cpu->cpu.SetStrictOpcodes(enabled != 0);
+}
+
+/* Through the run loop, which hands back and clears the stop, so the next run does not find it */
+void i8080_step(I8080Cpu* cpu) {
+    cpu->lastStop = cpu->cpu.RunUntil(cpu->cpu.Cycles() + 1);
+}
+
+int i8080_interrupt(I8080Cpu* cpu, int number) {
+    if (!cpu->cpu.State().intEnable)
+        return 0;
+    cpu->cpu.GenerateInterrupt(number);
+    return 1;
+}
+
+uint64_t i8080_cycles(const I8080Cpu* cpu) {
+    return cpu->cpu.Cycles();
+}
+
+uint8_t i8080_read(const I8080Cpu* cpu, uint16_t address) {
+    return cpu->memory[address];
+}
+
+void i8080_write(I8080Cpu* cpu, uint16_t address, uint8_t value) {
+    cpu->memory[address] = value;
+}
+
+uint8_t* i8080_memory(I8080Cpu* cpu) {
+    return cpu->memory;
+}
+
+void i8080_get_registers(const I8080Cpu* cpu, I8080Registers* registers) {
+    *registers = toRegisters(cpu->cpu.State());
+}
+
+void i8080_set_registers(I8080Cpu* cpu, const I8080Registers* registers) {
+    cpu->cpu.SetState(toState(*registers));
+}
+
+void i8080_set_io(I8080Cpu* cpu, i8080_in_handler input, i8080_out_handler output, void* context) {
+    cpu->cpu.SetIOHandlers(input, output, context);
+}
+
+size_t i8080_state_size(void) {
+    return sizeof(SavedState);
+}
+
+/* The buffer needs no alignment, the state is copied in and out byte by byte */
+void i8080_save_state(const I8080Cpu* cpu, void* buffer) {
+    auto* out = static_cast<uint8_t*>(buffer);
+    uint32_t header[2] = { stateMagic, I8080_ABI_VERSION };
+    I8080Registers registers = toRegisters(cpu->cpu.State());
+    uint64_t cycles = cpu->cpu.Cycles();
+    memcpy(out + offsetof(SavedState, magic), header, sizeof(header));
+    memcpy(out + offsetof(SavedState, registers), &registers, sizeof(registers));
+    memcpy(out + offsetof(SavedState, cycles), &cycles, sizeof(cycles));
+    memcpy(out + offsetof(SavedState, memory), cpu->memory, 0x10000);
+}
+
+int i8080_load_state(I8080Cpu* cpu, const void* buffer) {
+    auto* in = static_cast<const uint8_t*>(buffer);
+    uint32_t header[2];
+    memcpy(header, in + offsetof(SavedState, magic), sizeof(header));
+    if (header[0] != stateMagic || header[1] != I8080_ABI_VERSION)
+        return 0;
+
+    I8080Registers registers;
+    uint64_t cycles;
+    memcpy(&registers, in + offsetof(SavedState, registers), sizeof(registers));
+    memcpy(&cycles, in + offsetof(SavedState, cycles), sizeof(cycles));
+    memcpy(cpu->memory, in + offsetof(SavedState, memory), 0x10000);
+    cpu->cpu.SetState(toState(registers));
+    cpu->cpu.SetCycles(cycles);
+    return 1;
+}
@@ -0,0 +1,96 @@
+#ifndef EMULATOR8080C_H
+#define EMULATOR8080C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Stable C interface to the production core, built as the i8080 shared library.
+ *
+ * A handle owns the CPU and its 64 KiB of memory. No call allocates except i8080_create, state is
+ * saved into and loaded from buffers of the caller, i8080_state_size bytes long. The IN and OUT
+ * callbacks run on the thread calling i8080_run or i8080_step */
+#if defined(_WIN32)
+#ifdef I8080_BUILDING_LIBRARY
+#define I8080_API __declspec(dllexport)
+#else
+#define I8080_API __declspec(dllimport)
+#endif
+#else
+#define I8080_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define I8080_ABI_VERSION 1
+
+/* Why i8080_run or i8080_step returned before its cycles passed */
+#define I8080_STOP_NONE 0
+#define I8080_STOP_HALT 3              /* HLT with interrupts disabled */
+#define I8080_STOP_ILLEGAL_OPCODE 4    /* An undocumented opcode with strict opcodes on */
+#define I8080_STOP_FAULT 5             /* An IN or OUT handler called i8080_fault */
+
+typedef struct I8080Cpu I8080Cpu;
+
+typedef struct I8080Registers
+{
+    uint8_t a, b, c, d, e, h, l;
+    uint8_t flags;    /* S Z 0 AC 0 P 1 CY, as pushed by PUSH PSW */
+    uint16_t sp;
+    uint16_t pc;
+    uint8_t interrupts_enabled;
+    uint8_t halted;    /* Stopped by HLT, pc past it, until the next interrupt */
+} I8080Registers;
+
+typedef uint8_t (*i8080_in_handler)(void* context, uint8_t port);
+typedef void (*i8080_out_handler)(void* context, uint8_t port, uint8_t value);
+
+I8080_API uint32_t i8080_abi_version(void);
+
+/* NULL when out of memory. The memory starts zeroed, the program counter at 0 */
+I8080_API I8080Cpu* i8080_create(void);
+I8080_API void i8080_destroy(I8080Cpu* cpu);
+
+/* Copy a ROM image to the address, cut at the end of memory. Returns the bytes copied, -1 when
+ * the file cannot be read */
+I8080_API long i8080_load_rom(I8080Cpu* cpu, const char* path, uint16_t address);
+I8080_API size_t i8080_load_buffer(I8080Cpu* cpu, const uint8_t* data, size_t size, uint16_t address);
+
+/* Run whole instructions until at least the given cycles passed, or the CPU stopped, returns the
+ * cycles run. A stop ends the run of this handle only, i8080_stop_reason tells what stopped it */
+I8080_API uint64_t i8080_run(I8080Cpu* cpu, uint64_t cycles);
+/* I8080_STOP_ of the last i8080_run or i8080_step, with the address of the instruction that stopped
+ * it. A stop is reported by the call it happened in and cleared by the next one */
+I8080_API int i8080_stop_reason(const I8080Cpu* cpu, uint16_t* address);
+/* From an IN or OUT handler, end the run after the instruction with I8080_STOP_FAULT */
+I8080_API void i8080_fault(I8080Cpu* cpu);
+/* Stop on the undocumented opcodes instead of executing them as their documented twins */
+I8080_API void i8080_set_strict_opcodes(I8080Cpu* cpu, int enabled);
+/* Run a single instruction. A HLT with interrupts disabled or a fault during it is a stop as in i8080_run */
+I8080_API void i8080_step(I8080Cpu* cpu);
+/* RST number when interrupts are enabled, returns whether it was taken */
+I8080_API int i8080_interrupt(I8080Cpu* cpu, int number);
+I8080_API uint64_t i8080_cycles(const I8080Cpu* cpu);
+
+I8080_API uint8_t i8080_read(const I8080Cpu* cpu, uint16_t address);
+I8080_API void i8080_write(I8080Cpu* cpu, uint16_t address, uint8_t value);
+/* The 64 KiB themselves, for bulk access */
+I8080_API uint8_t* i8080_memory(I8080Cpu* cpu);
+
+I8080_API void i8080_get_registers(const I8080Cpu* cpu, I8080Registers* registers);
+I8080_API void i8080_set_registers(I8080Cpu* cpu, const I8080Registers* registers);
+
+/* Either handler may be NULL, IN then leaves the accumulator as it is and OUT does nothing */
+I8080_API void i8080_set_io(I8080Cpu* cpu, i8080_in_handler input, i8080_out_handler output, void* context);
+
+/* The registers, the clock and the memory. Loading returns 0 for a buffer not saved by this version */
+I8080_API size_t i8080_state_size(void);
+I8080_API void i8080_save_state(const I8080Cpu* cpu, void* buffer);
+I8080_API int i8080_load_state(I8080Cpu* cpu, const void* buffer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
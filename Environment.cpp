@@ -0,0 +1,265 @@
+#include "Environment.h"
+
+#include <algorithm>
+
+#include "Screen.h"
+
+
+namespace {
+    /* Player one's score, four BCD digits with the low two first, and the game mode, 0 outside a game */
+    constexpr uint16_t scoreAddress = 0x20F8;
+    constexpr uint16_t gameModeAddress = 0x20EF;
+
+    /* Frames at which startGame drops the coin and presses start, and the last frame it waits
+     * for the game to begin. A ROM that never starts one is saved as it is by then */
+    constexpr uint64_t coinFrame = 60;
+    constexpr uint64_t startFrame = 120;
+    constexpr uint64_t pressFrames = 6;
+    constexpr uint64_t lastStartFrame = 600;
+
+    uint32_t bcd(uint8_t value) {
+        return (value >> 4) * 10 + (value & 0x0F);
+    }
+
+    /* Largest factor up to the requested one dividing both sides of the screen */
+    int validDownscale(int requested) {
+        int downscale = std::max(requested, 1);
+        while (screenWidth % downscale || screenHeight % downscale)
+            --downscale;
+        return downscale;
+    }
+
+    uint16_t actionButtons(Environment::Action action) {
+        switch (action) {
+            case Environment::Fire: return InputDevice::Fire1;
+            case Environment::Left: return InputDevice::Left1;
+            case Environment::Right: return InputDevice::Right1;
+            case Environment::LeftFire: return InputDevice::Left1 | InputDevice::Fire1;
+            case Environment::RightFire: return InputDevice::Right1 | InputDevice::Fire1;
+            default: return 0;
+        }
+    }
+}
+
+
+/* The observation goes to the given buffer of ObservationSize bytes, or to one of the environment.
+ * A downscale factor not dividing both sides of the screen is lowered until it does */
+Environment::Environment(int downscaleFactor, uint8_t* observationBuffer) : started(false),
+    downscale(validDownscale(downscaleFactor)), observation(observationBuffer), score(0), playing(false),
+    done(false)
+{
+    if (!observation) {
+        ownObservation.resize(ObservationSize());
+        observation = ownObservation.data();
+    }
+    litPixels.resize(ObservationSize());
+    machine.Cpu().SetIdleSkip(true);
+}
+
+/* Load the ROM into a machine just powered on, before the first Reset */
+bool Environment::Load(const std::string& path) {
+    started = false;
+    return machine.LoadRom(path);
+}
+
+/* Start a game, from the saved start after the first one. Returns the first observation */
+const uint8_t* Environment::Reset() {
+    if (!started) {
+        startGame();
+        machine.SaveState(start);
+        started = true;
+    }
+    else
+        machine.LoadState(start);
+
+    machine.Input().SetButtons(0);
+    score = Score();
+    playing = gameMode() != 0;
+    done = false;
+    observe();
+    return observation;
+}
+
+void Environment::startGame() {
+    InputDevice& input = machine.Input();
+    while (machine.Frames() < lastStartFrame) {
+        uint64_t frame = machine.Frames();
+        uint16_t buttons = 0;
+        if (frame >= coinFrame && frame < coinFrame + pressFrames)
+            buttons = InputDevice::Coin;
+        else if (frame >= startFrame && frame < startFrame + pressFrames)
+            buttons = InputDevice::Start1;
+        else if (frame >= startFrame + pressFrames && gameMode() != 0)
+            break;
+        input.SetButtons(buttons);
+        machine.RunFrame();
+    }
+}
+
+/* Hold the controls of the action for the given frames. The game is done once it was running and
+ * went back to the attract mode, or when the CPU stopped and cannot go on */
+Environment::StepResult Environment::Step(Action action, int frames) {
+    machine.Input().SetButtons(actionButtons(action));
+    for (int i = 0; i < frames; i++) {
+        if (machine.RunFrame() != StopReason::None) {
+            done = true;
+            break;
+        }
+    }
+
+    uint32_t previous = score;
+    score = Score();
+    if (gameMode() != 0)
+        playing = true;
+    else if (playing)
+        done = true;
+    observe();
+    return { observation, score, static_cast<int32_t>(score) - static_cast<int32_t>(previous), done };
+}
+
+/* Count the lit pixels of every block, visiting only the video bytes with any */
+void Environment::observe() {
+    const uint8_t* videoRam = machine.VideoRam();
+    int width = Width();
+    std::fill(litPixels.begin(), litPixels.end(), 0);
+    for (int x = 0; x < screenWidth; x++) {
+        const uint8_t* column = videoRam + x * (screenHeight / 8);
+        for (int byte = 0; byte < screenHeight / 8; byte++) {
+            if (!column[byte])
+                continue;
+            for (int bit = 0; bit < 8; bit++) {
+                if ((column[byte] >> bit) & 1) {
+                    int y = screenHeight - 1 - (byte * 8 + bit);
+                    ++litPixels[(y / downscale) * width + x / downscale];
+                }
+            }
+        }
+    }
+
+    int blockPixels = downscale * downscale;
+    for (size_t i = 0; i < litPixels.size(); i++)
+        observation[i] = static_cast<uint8_t>(litPixels[i] * 255 / blockPixels);
+}
+
+uint8_t Environment::gameMode() const {
+    return machine.Memory()[gameModeAddress];
+}
+
+const uint8_t* Environment::Observation() const {
+    return observation;
+}
+
+int Environment::Width() const {
+    return screenWidth / downscale;
+}
+
+int Environment::Height() const {
+    return screenHeight / downscale;
+}
+
+size_t Environment::ObservationSize() const {
+    return static_cast<size_t>(Width()) * Height();
+}
+
+uint32_t Environment::Score() const {
+    const uint8_t* memory = machine.Memory();
+    return bcd(memory[scoreAddress + 1]) * 100 + bcd(memory[scoreAddress]);
+}
+
+bool Environment::Done() const {
+    return done;
+}
+
+SpaceInvaders<>& Environment::Machine() {
+    return machine;
+}
+
+
+/* Zero threads takes one per hardware thread */
+EnvironmentBatch::EnvironmentBatch(size_t count, int downscale, size_t threads) :
+    width(screenWidth / validDownscale(downscale)), height(screenHeight / validDownscale(downscale)),
+    observations(count * width * height), rewards(count), scores(count), dones(count), pool(threads),
+    actions(nullptr), frames(0)
+{
+    size_t observationSize = ObservationSize();
+    for (size_t i = 0; i < count; i++)
+        environments.push_back(std::make_unique<Environment>(downscale, observations.data() + i * observationSize));
+}
+
+bool EnvironmentBatch::Load(const std::string& path) {
+    for (auto& environment : environments) {
+        if (!environment->Load(path))
+            return false;
+    }
+    return true;
+}
+
+void EnvironmentBatch::Reset() {
+    pool.Run(environments.size(), resetOne, this);
+}
+
+/* One action per environment, each held for the same frames */
+void EnvironmentBatch::StepBatch(const uint8_t* stepActions, int stepFrames) {
+    actions = stepActions;
+    frames = stepFrames;
+    pool.Run(environments.size(), stepOne, this);
+}
+
+void EnvironmentBatch::resetOne(void* context, size_t index) {
+    auto* batch = static_cast<EnvironmentBatch*>(context);
+    Environment& environment = *batch->environments[index];
+    environment.Reset();
+    batch->rewards[index] = 0;
+    batch->scores[index] = environment.Score();
+    batch->dones[index] = 0;
+}
+
+void EnvironmentBatch::stepOne(void* context, size_t index) {
+    auto* batch = static_cast<EnvironmentBatch*>(context);
+    Environment& environment = *batch->environments[index];
+    if (environment.Done())
+        environment.Reset();
+
+    uint8_t action = batch->actions[index];
+    Environment::StepResult result = environment.Step(
+        action < Environment::actionCount ? static_cast<Environment::Action>(action) : Environment::Noop, batch->frames);
+    batch->rewards[index] = result.reward;
+    batch->scores[index] = result.score;
+    batch->dones[index] = result.done;
+}
+
+size_t EnvironmentBatch::Count() const {
+    return environments.size();
+}
+
+Environment& EnvironmentBatch::At(size_t index) {
+    return *environments[index];
+}
+
+const uint8_t* EnvironmentBatch::Observations() const {
+    return observations.data();
+}
+
+int EnvironmentBatch::Width() const {
+    return width;
+}
+
+int EnvironmentBatch::Height() const {
+    return height;
+}
+
+size_t EnvironmentBatch::ObservationSize() const {
+    return static_cast<size_t>(width) * height;
+}
+
+const int32_t* EnvironmentBatch::Rewards() const {
+    return rewards.data();
+}
+
+const uint32_t* EnvironmentBatch::Scores() const {
+    return scores.data();
+}
+
+const uint8_t* EnvironmentBatch::Dones() const {
+    return dones.data();
+}
@@ -0,0 +1,118 @@
+#ifndef ENVIRONMENT_H
+#define ENVIRONMENT_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "SpaceInvaders.h"
+#include "ThreadPool.h"
+
+/* Space Invaders as a reinforcement learning environment, for player one.
+ *
+ * Reset starts a game, inserting a coin and pressing start, and every later Reset goes back to that
+ * moment from a saved state. Step holds the controls of an action for a number of frames and returns
+ * the reward, the score gained meanwhile, read from the BCD score in RAM. The observation is the
+ * upright screen shrunk by the downscale factor, every byte the share of lit pixels in its block
+ * from 0 to 255. It is written in place, into a buffer of the caller or of the environment */
+class Environment
+{
+public:
+    enum Action : uint8_t
+    {
+        Noop,
+        Fire,
+        Left,
+        Right,
+        LeftFire,
+        RightFire
+    };
+
+    static constexpr int actionCount = 6;
+
+    struct StepResult
+    {
+        const uint8_t* observation;
+        uint32_t score;
+        int32_t reward;
+        bool done;
+    };
+
+    explicit Environment(int downscale = 2, uint8_t* observation = nullptr);
+    Environment(const Environment&) = delete;
+    Environment& operator=(const Environment&) = delete;
+
+    bool Load(const std::string& path);
+    const uint8_t* Reset();
+    StepResult Step(Action action, int frames);
+
+    const uint8_t* Observation() const;
+    int Width() const;
+    int Height() const;
+    size_t ObservationSize() const;
+    uint32_t Score() const;
+    bool Done() const;
+    SpaceInvaders<>& Machine();
+
+private:
+    void startGame();
+    void observe();
+    uint8_t gameMode() const;
+
+private:
+    SpaceInvaders<> machine;
+    SpaceInvaders<>::State start;
+    bool started;
+
+    int downscale;
+    std::vector<uint8_t> ownObservation;
+    uint8_t* observation;
+    std::vector<uint16_t> litPixels;
+
+    uint32_t score;
+    bool playing;
+    bool done;
+};
+
+/* Many environments stepped together on a thread pool. Their observations lie one after the other
+ * in a single buffer, with the rewards, scores and done flags in arrays of the same order.
+ * An environment whose game ended is reset by its next step, so its last observation stays readable */
+class EnvironmentBatch
+{
+public:
+    EnvironmentBatch(size_t count, int downscale = 2, size_t threads = 0);
+
+    bool Load(const std::string& path);
+    void Reset();
+    void StepBatch(const uint8_t* actions, int frames);
+
+    size_t Count() const;
+    Environment& At(size_t index);
+    const uint8_t* Observations() const;
+    int Width() const;
+    int Height() const;
+    size_t ObservationSize() const;
+    const int32_t* Rewards() const;
+    const uint32_t* Scores() const;
+    const uint8_t* Dones() const;
+
+private:
+    static void resetOne(void* context, size_t index);
+    static void stepOne(void* context, size_t index);
+
+private:
+    int width;
+    int height;
+    std::vector<uint8_t> observations;
+    std::vector<std::unique_ptr<Environment>> environments;
+    std::vector<int32_t> rewards;
+    std::vector<uint32_t> scores;
+    std::vector<uint8_t> dones;
+    ThreadPool pool;
+
+    const uint8_t* actions;
+    int frames;
+};
+
+#endif
@@ -0,0 +1,120 @@
+#include "EnvironmentC.h"
+
+#include "Environment.h"
+
+
+struct I8080Env
+{
+    Environment environment;
+};
+
+struct I8080EnvBatch
+{
+    I8080EnvBatch(size_t count, int downscale, size_t threads) : batch(count, downscale, threads)
+    { }
+
+    EnvironmentBatch batch;
+};
+
+/* No exception may leave these functions, allocation failures return NULL like a missing ROM */
+I8080Env* i8080_env_create(const char* rom, int downscale) {
+    if (!rom)
+        return nullptr;
+
+    I8080Env* env;
+    try {
+        env = new I8080Env { Environment(downscale) };
+    }
+    catch (...) {
+        return nullptr;
+    }
+    if (!env->environment.Load(rom)) {
+        delete env;
+        return nullptr;
+    }
+    return env;
+}
+
+void i8080_env_destroy(I8080Env* env) {
+    delete env;
+}
+
+const uint8_t* i8080_env_reset(I8080Env* env) {
+    return env->environment.Reset();
+}
+
+/* Actions out of range do nothing. Reward and done may be NULL */
+const uint8_t* i8080_env_step(I8080Env* env, int action, int frames, int32_t* reward, int* done) {
+    if (action < 0 || action >= Environment::actionCount)
+        action = Environment::Noop;
+    Environment::StepResult result = env->environment.Step(static_cast<Environment::Action>(action), frames);
+    if (reward)
+        *reward = result.reward;
+    if (done)
+        *done = result.done;
+    return result.observation;
+}
+
+const uint8_t* i8080_env_observation(const I8080Env* env) {
+    return env->environment.Observation();
+}
+
+void i8080_env_shape(const I8080Env* env, int* width, int* height) {
+    *width = env->environment.Width();
+    *height = env->environment.Height();
+}
+
+uint32_t i8080_env_score(const I8080Env* env) {
+    return env->environment.Score();
+}
+
+I8080EnvBatch* i8080_env_batch_create(const char* rom, size_t count, int downscale, size_t threads) {
+    if (!rom)
+        return nullptr;
+
+    I8080EnvBatch* batch;
+    try {
+        batch = new I8080EnvBatch(count, downscale, threads);
+    }
+    catch (...) {
+        return nullptr;
+    }
+    if (!batch->batch.Load(rom)) {
+        delete batch;
+        return nullptr;
+    }
+    return batch;
+}
+
+void i8080_env_batch_destroy(I8080EnvBatch* batch) {
+    delete batch;
+}
+
+void i8080_env_batch_reset(I8080EnvBatch* batch) {
+    batch->batch.Reset();
+}
+
+void i8080_env_batch_step(I8080EnvBatch* batch, const uint8_t* actions, int frames) {
+    batch->batch.StepBatch(actions, frames);
+}
+
+const uint8_t* i8080_env_batch_observations(const I8080EnvBatch* batch) {
+    return batch->batch.Observations();
+}
+
+void i8080_env_batch_shape(const I8080EnvBatch* batch, int* width, int* height) {
+    *width = batch->batch.Width();
+    *height = batch->batch.Height();
+}
+
+const int32_t* i8080_env_batch_rewards(const I8080EnvBatch* batch) {
+    return batch->batch.Rewards();
+}
+
+const uint32_t* i8080_env_batch_scores(const I8080EnvBatch* batch) {
+    return batch->batch.Scores();
+}
+
+const uint8_t* i8080_env_batch_dones(const I8080EnvBatch* batch) {
+    return batch->batch.Dones();
+}
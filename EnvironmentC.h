@@ -0,0 +1,54 @@
+#ifndef ENVIRONMENTC_H
+#define ENVIRONMENTC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* C interface to Environment and EnvironmentBatch, for bindings from other languages, built as the
+ * i8080env shared library. The handles are opaque, the returned observation pointers point into buffers owned by the
+ * handle, valid until it is destroyed and updated in place by every reset and step.
+ * Actions are 0 noop, 1 fire, 2 left, 3 right, 4 left and fire, 5 right and fire */
+#ifndef I8080_API
+#if defined(_WIN32)
+#ifdef I8080_BUILDING_LIBRARY
+#define I8080_API __declspec(dllexport)
+#else
+#define I8080_API __declspec(dllimport)
+#endif
+#else
+#define I8080_API __attribute__((visibility("default")))
+#endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct I8080Env I8080Env;
+typedef struct I8080EnvBatch I8080EnvBatch;
+
+/* NULL when the ROM cannot be read */
+I8080_API I8080Env* i8080_env_create(const char* rom, int downscale);
+I8080_API void i8080_env_destroy(I8080Env* env);
+I8080_API const uint8_t* i8080_env_reset(I8080Env* env);
+I8080_API const uint8_t* i8080_env_step(I8080Env* env, int action, int frames, int32_t* reward, int* done);
+I8080_API const uint8_t* i8080_env_observation(const I8080Env* env);
+I8080_API void i8080_env_shape(const I8080Env* env, int* width, int* height);
+I8080_API uint32_t i8080_env_score(const I8080Env* env);
+
+/* Zero threads takes one per hardware thread */
+I8080_API I8080EnvBatch* i8080_env_batch_create(const char* rom, size_t count, int downscale, size_t threads);
+I8080_API void i8080_env_batch_destroy(I8080EnvBatch* batch);
+I8080_API void i8080_env_batch_reset(I8080EnvBatch* batch);
+I8080_API void i8080_env_batch_step(I8080EnvBatch* batch, const uint8_t* actions, int frames);
+I8080_API const uint8_t* i8080_env_batch_observations(const I8080EnvBatch* batch);
+I8080_API void i8080_env_batch_shape(const I8080EnvBatch* batch, int* width, int* height);
+I8080_API const int32_t* i8080_env_batch_rewards(const I8080EnvBatch* batch);
+I8080_API const uint32_t* i8080_env_batch_scores(const I8080EnvBatch* batch);
+I8080_API const uint8_t* i8080_env_batch_dones(const I8080EnvBatch* batch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
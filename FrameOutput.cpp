@@ -0,0 +1,48 @@
+#include "FrameOutput.h"
+
+#include <chrono>
+
+
+FrameOutput::FrameOutput(FrameQueue& queue, FrameHandler handler, void* context) : queue(queue),
+    handler(handler), context(context), stopping(false), consumed(0), thread(&FrameOutput::run, this)
+{ }
+
+FrameOutput::~FrameOutput() {
+    Stop();
+}
+
+/* Let the thread finish the buffers already queued, then join it */
+void FrameOutput::Stop() {
+    stopping.store(true);
+    if (thread.joinable())
+        thread.join();
+}
+
+uint64_t FrameOutput::Consumed() const {
+    return consumed.load(std::memory_order_relaxed);
+}
+
+/* The queue never blocks, so an empty one is polled: yielding at first to keep up with a producer
+ * running unthrottled, then sleeping at a rate still well above the frame rate */
+void FrameOutput::run() {
+    int idlePolls = 0;
+    while (true) {
+        bool finished = stopping.load();
+        const FrameQueue::Frame* frame = queue.BeginPop();
+        if (!frame) {
+            if (finished)
+                return;
+            if (++idlePolls < 64)
+                std::this_thread::yield();
+            else
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        idlePolls = 0;
+
+        if (handler)
+            handler(context, *frame);
+        queue.EndPop();
+        consumed.fetch_add(1, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef FRAMEOUTPUT_H
+#define FRAMEOUTPUT_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "FrameQueue.h"
+
+/* Output thread handing every buffer of a FrameQueue to a handler, such as a display or an encoder,
+ * away from the emulation thread. Without a handler the buffers are only counted */
+class FrameOutput
+{
+public:
+    using FrameHandler = void (*)(void* context, const FrameQueue::Frame& frame);
+
+    FrameOutput(FrameQueue& queue, FrameHandler handler, void* context);
+    FrameOutput(const FrameOutput&) = delete;
+    FrameOutput& operator=(const FrameOutput&) = delete;
+    ~FrameOutput();
+
+    void Stop();
+    uint64_t Consumed() const;
+
+private:
+    void run();
+
+private:
+    FrameQueue& queue;
+    FrameHandler handler;
+    void* context;
+
+    std::atomic<bool> stopping;
+    std::atomic<uint64_t> consumed;
+    std::thread thread;
+};
+
+#endif
@@ -0,0 +1,67 @@
+#include "FramePacer.h"
+
+#include <thread>
+
+
+namespace {
+    /* Further behind than this the pacer stops catching up and starts again from now */
+    constexpr std::chrono::milliseconds maxLag(250);
+    /* A frame finishing later than this after its time is not rendered */
+    constexpr std::chrono::milliseconds renderLag(20);
+}
+
+
+FramePacer::FramePacer(Mode mode, uint32_t cpuFrequency, int renderInterval) : mode(mode),
+    frequency(cpuFrequency), renderInterval(renderInterval > 0 ? renderInterval : 1), originCycles(0),
+    frames(0), rendered(0), late(0)
+{
+    Reset(0);
+}
+
+/* Start pacing from now at the given clock of the machine */
+void FramePacer::Reset(uint64_t cycles) {
+    origin = Clock::now();
+    originCycles = cycles;
+}
+
+/* Called after every emulated frame with the clock of the machine, waits when running in real time.
+ * Returns whether the frame should be rendered */
+bool FramePacer::FrameDone(uint64_t cycles) {
+    ++frames;
+
+    bool render;
+    if (mode == Mode::Turbo)
+        render = frames % renderInterval == 0;
+    else {
+        auto emulated = std::chrono::duration<double>(static_cast<double>(cycles - originCycles) / frequency);
+        Clock::time_point due = origin + std::chrono::duration_cast<Clock::duration>(emulated);
+        Clock::time_point now = Clock::now();
+
+        if (now <= due) {
+            std::this_thread::sleep_until(due);
+            render = true;
+        }
+        else {
+            ++late;
+            render = now - due <= renderLag;
+            if (now - due > maxLag)
+                Reset(cycles);
+        }
+    }
+
+    if (render)
+        ++rendered;
+    return render;
+}
+
+uint64_t FramePacer::Frames() const {
+    return frames;
+}
+
+uint64_t FramePacer::RenderedFrames() const {
+    return rendered;
+}
+
+uint64_t FramePacer::LateFrames() const {
+    return late;
+}
@@ -0,0 +1,44 @@
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+#include <chrono>
+#include <cstdint>
+
+/* Paces a machine between frames and decides which frames get rendered:
+ *   RealTime - the emulated clock is held to the CPU frequency against the monotonic clock,
+ *              sleeping while ahead and skipping the rendering of frames that came late
+ *   Turbo    - no waiting at all, only every Nth frame is rendered */
+class FramePacer
+{
+public:
+    enum class Mode
+    {
+        RealTime,
+        Turbo
+    };
+
+    FramePacer(Mode mode, uint32_t cpuFrequency, int renderInterval = 1);
+
+    void Reset(uint64_t cycles);
+    bool FrameDone(uint64_t cycles);
+
+    uint64_t Frames() const;
+    uint64_t RenderedFrames() const;
+    uint64_t LateFrames() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Mode mode;
+    uint32_t frequency;
+    int renderInterval;
+
+    Clock::time_point origin;
+    uint64_t originCycles;
+
+    uint64_t frames;
+    uint64_t rendered;
+    uint64_t late;
+};
+
+#endif
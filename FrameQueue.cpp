@@ -0,0 +1,106 @@
+#include "FrameQueue.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+/* At least three slots, one may be read in place while the others take new buffers */
+FrameQueue::FrameQueue(size_t slots, size_t slotSize) : buffers(std::max<size_t>(slots, 3) * slotSize),
+    frames(std::max<size_t>(slots, 3)), slotSize(slotSize), write(0), read(0), reading(idle), pushed(0),
+    dropped(0), late(0)
+{
+    for (size_t i = 0; i < frames.size(); i++)
+        frames[i] = { 0, 0, 0, buffers.data() + i * slotSize, true };
+}
+
+/* Slot to fill for the next buffer, nullptr when it has to be dropped. Frees the oldest slot when full.
+ *
+ * The consumer publishes the sequence it is about to read before claiming it from read, and the
+ * producer checks it only after its own claim. Every operation is sequentially consistent, so
+ * either the consumer's claim fails or the producer sees the sequence being read */
+FrameQueue::Frame* FrameQueue::BeginPush() {
+    uint64_t sequence = write.load(std::memory_order_relaxed);
+    uint64_t oldest = read.load();
+    while (sequence - oldest >= frames.size()) {
+        if (read.compare_exchange_weak(oldest, oldest + 1)) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+    }
+
+    uint64_t inUse = reading.load();
+    if (inUse != idle && inUse % frames.size() == sequence % frames.size()) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Frame* frame = &frames[sequence % frames.size()];
+    frame->sequence = sequence;
+    return frame;
+}
+
+/* Publish the slot returned by BeginPush */
+void FrameQueue::EndPush() {
+    write.store(write.load(std::memory_order_relaxed) + 1);
+    pushed.fetch_add(1, std::memory_order_relaxed);
+}
+
+/* Copy a buffer into the ring, false when it was dropped. Longer buffers are cut to the slot size */
+bool FrameQueue::Push(const uint8_t* data, size_t size, uint64_t cycles, bool render) {
+    Frame* frame = BeginPush();
+    if (!frame)
+        return false;
+
+    frame->size = std::min(size, slotSize);
+    frame->cycles = cycles;
+    frame->render = render;
+    memcpy(frame->data, data, frame->size);
+    EndPush();
+    return true;
+}
+
+/* Whether the next push could drop a buffer. One slot is kept for the buffer the consumer may be
+ * reading, so a producer waiting while this holds never loses one */
+bool FrameQueue::Full() const {
+    return write.load(std::memory_order_relaxed) - read.load() >= frames.size() - 1;
+}
+
+/* Oldest unread buffer, nullptr when empty. It stays valid until EndPop.
+ * A buffer is late when a newer one was already published by the time it is taken */
+const FrameQueue::Frame* FrameQueue::BeginPop() {
+    uint64_t sequence = read.load();
+    while (true) {
+        uint64_t newest = write.load();
+        if (sequence == newest)
+            return nullptr;
+
+        reading.store(sequence);
+        if (read.compare_exchange_strong(sequence, sequence + 1)) {
+            if (newest - sequence > 1)
+                late.fetch_add(1, std::memory_order_relaxed);
+            return &frames[sequence % frames.size()];
+        }
+        reading.store(idle);
+    }
+}
+
+/* Hand the buffer from BeginPop back to the producer */
+void FrameQueue::EndPop() {
+    reading.store(idle);
+}
+
+size_t FrameQueue::SlotSize() const {
+    return slotSize;
+}
+
+uint64_t FrameQueue::Pushed() const {
+    return pushed.load(std::memory_order_relaxed);
+}
+
+uint64_t FrameQueue::Dropped() const {
+    return dropped.load(std::memory_order_relaxed);
+}
+
+uint64_t FrameQueue::Late() const {
+    return late.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,65 @@
+#ifndef FRAMEQUEUE_H
+#define FRAMEQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/* Lock-free single-producer/single-consumer ring of preallocated buffers, for handing video frames
+ * or audio blocks from the emulation thread to an output thread without ever blocking the producer.
+ *
+ * When the ring is full the producer drops the oldest unread buffer. Buffers are filled and read in
+ * place, so the producer also has to stay off the buffer the consumer is reading, the new buffer
+ * is dropped instead in the rare case it would land there */
+class FrameQueue
+{
+public:
+    struct Frame
+    {
+        uint64_t sequence;
+        uint64_t cycles;
+        size_t size;
+        uint8_t* data;
+        /* Whether a display should show the buffer, the other consumers take every one */
+        bool render;
+    };
+
+    FrameQueue(size_t slots, size_t slotSize);
+    FrameQueue(const FrameQueue&) = delete;
+    FrameQueue& operator=(const FrameQueue&) = delete;
+
+    /* Producer side */
+    Frame* BeginPush();
+    void EndPush();
+    bool Push(const uint8_t* data, size_t size, uint64_t cycles, bool render = true);
+    bool Full() const;
+
+    /* Consumer side */
+    const Frame* BeginPop();
+    void EndPop();
+
+    size_t SlotSize() const;
+    uint64_t Pushed() const;
+    uint64_t Dropped() const;
+    uint64_t Late() const;
+
+private:
+    static constexpr uint64_t idle = UINT64_MAX;
+
+    std::vector<uint8_t> buffers;
+    std::vector<Frame> frames;
+    size_t slotSize;
+
+    /* Next sequence the producer writes and next one the consumer reads, both only ever grow */
+    std::atomic<uint64_t> write;
+    std::atomic<uint64_t> read;
+    /* Sequence the consumer is reading in place, idle when none */
+    std::atomic<uint64_t> reading;
+
+    std::atomic<uint64_t> pushed;
+    std::atomic<uint64_t> dropped;
+    std::atomic<uint64_t> late;
+};
+
+#endif
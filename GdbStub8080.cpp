@@ -0,0 +1,538 @@
+#include "GdbStub8080.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace {
+    constexpr int registerCount = 13;
+    constexpr size_t maxMemoryRead = 2040;
+    constexpr int sigint = 2;
+    constexpr int sigill = 4;
+    constexpr int sigtrap = 5;
+    constexpr int sigsegv = 11;
+
+    const char hexDigits[] = "0123456789abcdef";
+
+    void appendHex(std::string& out, uint8_t byte) {
+        out += hexDigits[byte >> 4];
+        out += hexDigits[byte & 0x0F];
+    }
+
+    int hexValue(char digit) {
+        if (digit >= '0' && digit <= '9')
+            return digit - '0';
+        if (digit >= 'a' && digit <= 'f')
+            return digit - 'a' + 10;
+        if (digit >= 'A' && digit <= 'F')
+            return digit - 'A' + 10;
+        return -1;
+    }
+
+    /* Two hex digits at the given position, -1 if there are none */
+    int hexByte(const std::string& hex, size_t position) {
+        if (position + 1 >= hex.size())
+            return -1;
+        int high = hexValue(hex[position]);
+        int low = hexValue(hex[position + 1]);
+        return (high < 0 || low < 0) ? -1 : (high << 4) | low;
+    }
+
+    /* Big-endian hex number as used for addresses and lengths, stops at the first non hex digit */
+    unsigned long parseHex(const std::string& text, size_t& position) {
+        unsigned long value = 0;
+        while (position < text.size() && hexValue(text[position]) >= 0)
+            value = (value << 4) | hexValue(text[position++]);
+        return value;
+    }
+
+    /* Illegal opcodes and device faults are reported as the signals a native program would get, the rest as traps */
+    int stopSignal(StopReason reason) {
+        if (reason == StopReason::IllegalOpcode)
+            return sigill;
+        if (reason == StopReason::Fault)
+            return sigsegv;
+        return sigtrap;
+    }
+}
+
+
+GdbStub8080::GdbStub8080(Emulator8080<DebugPolicies>& cpu, uint8_t* memory, Debugger8080& debugger) :
+    cpu(cpu), memory(memory), debugger(debugger), listener(-1), connection(-1), stopped(false), running(true),
+    lastSignal(sigtrap), lastStop(StopReason::None)
+{ }
+
+GdbStub8080::~GdbStub8080() {
+    close();
+    if (listener >= 0)
+        ::close(listener);
+    if (!unixPath.empty())
+        unlink(unixPath.c_str());
+}
+
+/* Listen on "unix:PATH" or on "[localhost:]PORT" of the loopback interface and wait for the debugger.
+ * The target is stopped once it attached, as GDB expects */
+bool GdbStub8080::Open(const std::string& endpoint) {
+    if (endpoint.compare(0, 5, "unix:") == 0) {
+        sockaddr_un address{};
+        unixPath = endpoint.substr(5);
+        if (unixPath.empty() || unixPath.size() >= sizeof(address.sun_path)) {
+            fprintf(stderr, "Error: bad socket path %s\n", unixPath.c_str());
+            return false;
+        }
+        address.sun_family = AF_UNIX;
+        memcpy(address.sun_path, unixPath.c_str(), unixPath.size());
+        unlink(unixPath.c_str());
+
+        listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+            fprintf(stderr, "Error: cannot bind %s: %s\n", unixPath.c_str(), strerror(errno));
+            return false;
+        }
+    }
+    else {
+        size_t separator = endpoint.rfind(':');
+        int port = atoi(endpoint.c_str() + (separator == std::string::npos ? 0 : separator + 1));
+        if (port <= 0 || port > 0xFFFF) {
+            fprintf(stderr, "Error: bad port %s\n", endpoint.c_str());
+            return false;
+        }
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(port));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        int reuse = 1;
+        listener = socket(AF_INET, SOCK_STREAM, 0);
+        if (listener >= 0)
+            setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if (listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+            fprintf(stderr, "Error: cannot bind port %d: %s\n", port, strerror(errno));
+            return false;
+        }
+    }
+
+    if (listen(listener, 1) < 0) {
+        fprintf(stderr, "Error: cannot listen: %s\n", strerror(errno));
+        return false;
+    }
+
+    fprintf(stderr, "Waiting for the debugger on %s\n", endpoint.c_str());
+    connection = accept(listener, nullptr, nullptr);
+    if (connection < 0) {
+        fprintf(stderr, "Error: cannot accept: %s\n", strerror(errno));
+        return false;
+    }
+
+    int noDelay = 1;
+    setsockopt(connection, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    fcntl(connection, F_SETFL, fcntl(connection, F_GETFL) | O_NONBLOCK);
+    stopped = true;
+    return true;
+}
+
+/* Serve the debugger at a batch boundary. Returns false once the debugger killed the target */
+bool GdbStub8080::Poll() {
+    if (connection < 0)
+        return running;
+
+    if (!receive(false) || !handlePackets()) {
+        close();
+        return running;
+    }
+
+    while (stopped && connection >= 0) {
+        if (!receive(true) || !handlePackets())
+            close();
+    }
+    return running;
+}
+
+/* The run loop stopped early, hold the target until the debugger resumes it */
+void GdbStub8080::ReportStop(StopReason reason) {
+    if (connection < 0)
+        return;
+
+    stopped = true;
+    sendStopReply(stopSignal(reason), reason);
+}
+
+/* Append whatever arrived to the input, waiting for it when blocking. Returns false when the connection ended */
+bool GdbStub8080::receive(bool block) {
+    if (block) {
+        pollfd descriptor{ connection, POLLIN, 0 };
+        while (poll(&descriptor, 1, -1) < 0) {
+            if (errno != EINTR)
+                return false;
+        }
+    }
+
+    char buffer[4096];
+    while (true) {
+        ssize_t size = recv(connection, buffer, sizeof(buffer), 0);
+        if (size > 0) {
+            input.append(buffer, static_cast<size_t>(size));
+            continue;
+        }
+        if (size == 0)
+            return false;
+        if (errno == EINTR)
+            continue;
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+}
+
+/* Handle every complete packet in the input, an interrupt byte stops a running target.
+ * Returns false when the debugger detached or killed the target */
+bool GdbStub8080::handlePackets() {
+    size_t position = 0;
+    while (position < input.size() && connection >= 0) {
+        char byte = input[position];
+        if (byte == '\x03') {
+            ++position;
+            if (!stopped) {
+                stopped = true;
+                sendStopReply(sigint, StopReason::None);
+            }
+            continue;
+        }
+        if (byte != '$') {
+            ++position;
+            continue;
+        }
+
+        size_t end = input.find('#', position);
+        if (end == std::string::npos || end + 2 >= input.size())
+            break;
+
+        std::string packet = input.substr(position + 1, end - position - 1);
+        uint8_t sum = 0;
+        for (char character : packet)
+            sum += static_cast<uint8_t>(character);
+        int expected = hexByte(input, end + 1);
+        position = end + 3;
+
+        if (expected != sum) {
+            sendAll("-", 1);
+            continue;
+        }
+        sendAll("+", 1);
+        handlePacket(packet);
+    }
+    input.erase(0, position);
+    return connection >= 0;
+}
+
+void GdbStub8080::handlePacket(const std::string& packet) {
+    if (packet.empty()) {
+        sendPacket("");
+        return;
+    }
+
+    std::string args = packet.substr(1);
+    switch (packet[0]) {
+        case '?':
+            sendStopReply(lastSignal, lastStop);
+            break;
+        case 'g':
+            sendPacket(readRegisters());
+            break;
+        case 'G':
+            writeRegisters(args);
+            sendPacket("OK");
+            break;
+        case 'p': {
+            size_t position = 0;
+            int number = static_cast<int>(parseHex(args, position));
+            uint16_t value = readRegister(number);
+            std::string out;
+            appendHex(out, value & 0xFF);
+            appendHex(out, value >> 8);
+            sendPacket(out);
+            break;
+        }
+        case 'P': {
+            size_t position = 0;
+            int number = static_cast<int>(parseHex(args, position));
+            int low = hexByte(args, position + 1);
+            int high = hexByte(args, position + 3);
+            if (position >= args.size() || args[position] != '=' || low < 0) {
+                sendPacket("E01");
+                break;
+            }
+            writeRegister(number, static_cast<uint16_t>(low | ((high < 0 ? 0 : high) << 8)));
+            sendPacket("OK");
+            break;
+        }
+        case 'm':
+            sendPacket(readMemory(args));
+            break;
+        case 'M':
+            sendPacket(writeMemory(args) ? "OK" : "E01");
+            break;
+        case 'c':
+        case 's': {
+            /* Resuming at an address leaves a HLT the CPU was halted on */
+            if (!args.empty()) {
+                size_t position = 0;
+                CpuState state = cpu.State();
+                state.pc = static_cast<uint16_t>(parseHex(args, position));
+                state.halted = 0;
+                cpu.SetState(state);
+            }
+            /* A single instruction through the run loop, which hands back and clears whatever stopped
+             * it, so the next continue does not report the same stop again */
+            if (packet[0] == 's') {
+                StopReason reason = cpu.RunUntil(cpu.Cycles() + 1);
+                sendStopReply(stopSignal(reason), reason);
+            }
+            else
+                stopped = false;
+            break;
+        }
+        case 'Z':
+        case 'z':
+            if (!setPoint(args, packet[0] == 'Z'))
+                sendPacket("");
+            else
+                sendPacket("OK");
+            break;
+        case 'D':
+            sendPacket("OK");
+            close();
+            break;
+        case 'k':
+            running = false;
+            close();
+            break;
+        case 'H':
+        case 'T':
+            sendPacket("OK");
+            break;
+        case 'q':
+            if (packet.compare(0, 10, "qSupported") == 0)
+                sendPacket("PacketSize=1000");
+            else if (packet == "qAttached")
+                sendPacket("1");
+            else
+                sendPacket("");
+            break;
+        default:
+            sendPacket("");
+            break;
+    }
+}
+
+void GdbStub8080::sendPacket(const std::string& data) {
+    uint8_t sum = 0;
+    for (char character : data)
+        sum += static_cast<uint8_t>(character);
+
+    std::string out = "$" + data + "#";
+    appendHex(out, sum);
+    sendAll(out.data(), out.size());
+}
+
+/* Report the stop, naming the watched address when a memory watchpoint caused it. The last hit of
+ * the debugger outlives its stop, so it is only looked at for a watchpoint stop */
+void GdbStub8080::sendStopReply(int signal, StopReason reason) {
+    std::string out = "T";
+    appendHex(out, static_cast<uint8_t>(signal));
+    lastSignal = signal;
+    lastStop = reason;
+
+    const Debugger8080::Hit& hit = debugger.LastHit();
+    if (reason == StopReason::Watchpoint && (hit.event == Debugger8080::Event::MemoryRead ||
+                                             hit.event == Debugger8080::Event::MemoryWrite)) {
+        bool both = debugger.IsReadWatched(hit.address) && debugger.IsWriteWatched(hit.address);
+        if (both)
+            out += "awatch:";
+        else
+            out += hit.event == Debugger8080::Event::MemoryRead ? "rwatch:" : "watch:";
+        appendHex(out, hit.address >> 8);
+        appendHex(out, hit.address & 0xFF);
+        out += ";";
+    }
+    sendPacket(out);
+}
+
+/* The connection is non-blocking, so wait for room when the debugger reads slowly */
+bool GdbStub8080::sendAll(const char* data, size_t size) {
+    while (size > 0 && connection >= 0) {
+        ssize_t sent = send(connection, data, size, MSG_NOSIGNAL);
+        if (sent > 0) {
+            data += sent;
+            size -= static_cast<size_t>(sent);
+        }
+        else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            pollfd descriptor{ connection, POLLOUT, 0 };
+            poll(&descriptor, 1, -1);
+        }
+        else if (errno != EINTR) {
+            close();
+            return false;
+        }
+    }
+    return connection >= 0;
+}
+
+std::string GdbStub8080::readRegisters() const {
+    std::string out;
+    for (int number = 0; number < registerCount; number++) {
+        uint16_t value = readRegister(number);
+        appendHex(out, value & 0xFF);
+        appendHex(out, value >> 8);
+    }
+    return out;
+}
+
+void GdbStub8080::writeRegisters(const std::string& hex) {
+    for (int number = 0; number < registerCount; number++) {
+        int low = hexByte(hex, 4 * number);
+        int high = hexByte(hex, 4 * number + 2);
+        if (low < 0 || high < 0)
+            return;
+        writeRegister(number, static_cast<uint16_t>(low | (high << 8)));
+    }
+}
+
+/* AF, BC, DE, HL, SP and PC, the flags byte laid out as PUSH PSW stores it */
+uint16_t GdbStub8080::readRegister(int number) const {
+    CpuState state = cpu.State();
+    uint8_t flags = static_cast<uint8_t>(state.cc.cy | 0x02 | (state.cc.p << 2) | (state.cc.ac << 4) |
+                                         (state.cc.z << 6) | (state.cc.s << 7));
+    switch (number) {
+        case 0: return static_cast<uint16_t>((state.a << 8) | flags);
+        case 1: return static_cast<uint16_t>((state.b << 8) | state.c);
+        case 2: return static_cast<uint16_t>((state.d << 8) | state.e);
+        case 3: return static_cast<uint16_t>((state.h << 8) | state.l);
+        case 4: return state.sp;
+        case 5: return state.pc;
+        default: return 0;
+    }
+}
+
+void GdbStub8080::writeRegister(int number, uint16_t value) {
+    CpuState state = cpu.State();
+    uint8_t high = value >> 8;
+    uint8_t low = value & 0xFF;
+    switch (number) {
+        case 0:
+            state.a = high;
+            state.cc.cy = low & 0x01;
+            state.cc.p = (low >> 2) & 0x01;
+            state.cc.ac = (low >> 4) & 0x01;
+            state.cc.z = (low >> 6) & 0x01;
+            state.cc.s = (low >> 7) & 0x01;
+            break;
+        case 1: state.b = high; state.c = low; break;
+        case 2: state.d = high; state.e = low; break;
+        case 3: state.h = high; state.l = low; break;
+        case 4: state.sp = value; break;
+        case 5: state.pc = value; break;
+        default: return;
+    }
+    cpu.SetState(state);
+}
+
+/* "ADDR,LENGTH", the address wraps around the 64 KiB space */
+std::string GdbStub8080::readMemory(const std::string& args) const {
+    size_t position = 0;
+    unsigned long address = parseHex(args, position);
+    if (position >= args.size() || args[position] != ',')
+        return "E01";
+    ++position;
+    unsigned long length = parseHex(args, position);
+    if (length > maxMemoryRead)
+        length = maxMemoryRead;
+
+    std::string out;
+    for (unsigned long i = 0; i < length; i++)
+        appendHex(out, memory[(address + i) & 0xFFFF]);
+    return out;
+}
+
+/* "ADDR,LENGTH:BYTES" */
+bool GdbStub8080::writeMemory(const std::string& args) {
+    size_t position = 0;
+    unsigned long address = parseHex(args, position);
+    if (position >= args.size() || args[position] != ',')
+        return false;
+    ++position;
+    unsigned long length = parseHex(args, position);
+    if (position >= args.size() || args[position] != ':')
+        return false;
+    ++position;
+
+    for (unsigned long i = 0; i < length; i++) {
+        int byte = hexByte(args, position + 2 * i);
+        if (byte < 0)
+            return false;
+        memory[(address + i) & 0xFFFF] = static_cast<uint8_t>(byte);
+    }
+    return true;
+}
+
+/* "TYPE,ADDR,KIND" of Z and z, software and hardware breakpoints are the same bitmap here.
+ * The watchpoints cover KIND bytes. Returns false for an unsupported type */
+bool GdbStub8080::setPoint(const std::string& args, bool enabled) {
+    size_t position = 0;
+    unsigned long type = parseHex(args, position);
+    if (position >= args.size() || args[position] != ',')
+        return false;
+    ++position;
+    unsigned long address = parseHex(args, position);
+    unsigned long kind = 1;
+    if (position < args.size() && args[position] == ',') {
+        ++position;
+        kind = parseHex(args, position);
+    }
+    if (kind == 0)
+        kind = 1;
+
+    switch (type) {
+        case 0:
+        case 1:
+            debugger.SetBreakpoint(static_cast<uint16_t>(address), enabled);
+            return true;
+        case 2:
+        case 3:
+        case 4:
+            for (unsigned long i = 0; i < kind && i < 0x10000; i++) {
+                uint16_t watched = static_cast<uint16_t>(address + i);
+                if (type != 3)
+                    debugger.SetWriteWatchpoint(watched, enabled);
+                if (type != 2)
+                    debugger.SetReadWatchpoint(watched, enabled);
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+/* Drop the debugger, its breakpoints and watchpoints go with it and the target runs on */
+void GdbStub8080::close() {
+    if (connection >= 0) {
+        ::close(connection);
+        connection = -1;
+    }
+    input.clear();
+    debugger.ClearAll();
+    stopped = false;
+}
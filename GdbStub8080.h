@@ -0,0 +1,63 @@
+#ifndef GDBSTUB8080_H
+#define GDBSTUB8080_H
+
+#include <cstdint>
+#include <string>
+
+#include "Debugger8080.h"
+#include "Emulator8080.h"
+
+/* GDB remote serial protocol stub for one debugger on a localhost TCP port or a Unix socket.
+ * The registers are sent in the layout of the GDB z80 target (af bc de hl sp pc ix iy af' bc'
+ * de' hl' ir, 16 bits each), the registers the 8080 lacks read as zero.
+ *
+ * The machine loop calls Poll at every batch boundary. While the target runs that is a single
+ * non-blocking read, while the debugger holds it stopped Poll blocks serving its requests */
+class GdbStub8080
+{
+public:
+    GdbStub8080(Emulator8080<DebugPolicies>& cpu, uint8_t* memory, Debugger8080& debugger);
+    GdbStub8080(const GdbStub8080&) = delete;
+    GdbStub8080& operator=(const GdbStub8080&) = delete;
+    ~GdbStub8080();
+
+    bool Open(const std::string& endpoint);
+    bool Poll();
+    void ReportStop(StopReason reason);
+
+private:
+    bool receive(bool block);
+    bool handlePackets();
+    void handlePacket(const std::string& packet);
+
+    void sendPacket(const std::string& data);
+    void sendStopReply(int signal, StopReason reason);
+    bool sendAll(const char* data, size_t size);
+
+    std::string readRegisters() const;
+    void writeRegisters(const std::string& hex);
+    uint16_t readRegister(int number) const;
+    void writeRegister(int number, uint16_t value);
+    std::string readMemory(const std::string& args) const;
+    bool writeMemory(const std::string& args);
+    bool setPoint(const std::string& args, bool enabled);
+
+    void close();
+
+private:
+    Emulator8080<DebugPolicies>& cpu;
+    uint8_t* memory;
+    Debugger8080& debugger;
+
+    int listener;
+    int connection;
+    std::string unixPath;
+    std::string input;
+
+    bool stopped;
+    bool running;
+    int lastSignal;
+    StopReason lastStop;
+};
+
+#endif
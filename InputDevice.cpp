@@ -0,0 +1,121 @@
+#include "InputDevice.h"
+
+#include <cstring>
+
+
+namespace {
+    constexpr uint64_t neverPolled = UINT64_MAX;
+
+    /* Port 2 bits 0-1 hold the lives minus three, bit 3 the extra life at 1000 instead of 1500,
+     * bit 7 hides the coin info on the title screen */
+    constexpr uint8_t livesMask = 0x03;
+    constexpr uint8_t extraLife1000 = 0x08;
+    constexpr uint8_t coinInfoHidden = 0x80;
+
+    struct NamedButton
+    {
+        const char* name;
+        InputDevice::Button button;
+    };
+
+    constexpr NamedButton buttonNames[InputDevice::buttonCount] = {
+        { "coin", InputDevice::Coin },
+        { "start1", InputDevice::Start1 },
+        { "start2", InputDevice::Start2 },
+        { "fire1", InputDevice::Fire1 },
+        { "left1", InputDevice::Left1 },
+        { "right1", InputDevice::Right1 },
+        { "fire2", InputDevice::Fire2 },
+        { "left2", InputDevice::Left2 },
+        { "right2", InputDevice::Right2 },
+        { "tilt", InputDevice::Tilt }
+    };
+
+    uint8_t bit(uint16_t buttons, InputDevice::Button button, int position) {
+        return (buttons & button) ? static_cast<uint8_t>(1 << position) : 0;
+    }
+}
+
+
+/* Three lives, the extra life at 1500 points and the coin info shown, the factory settings */
+InputDevice::InputDevice() : source(nullptr), context(nullptr), polledFrame(neverPolled), buttons(0),
+    dipSwitches(0)
+{ }
+
+/* Attach the source setting the buttons before every frame, nullptr leaves them to the API */
+void InputDevice::SetSource(SourceHandler handler, void* sourceContext) {
+    source = handler;
+    context = sourceContext;
+    polledFrame = neverPolled;
+}
+
+/* Ask the source for the buttons of the frame, only once however often the frame is resumed */
+void InputDevice::Poll(uint64_t frame) {
+    if (!source || frame == polledFrame)
+        return;
+    polledFrame = frame;
+    source(context, frame, *this);
+}
+
+void InputDevice::Press(Button button) {
+    buttons |= button;
+}
+
+void InputDevice::Release(Button button) {
+    buttons &= ~button;
+}
+
+void InputDevice::SetButtons(uint16_t pressed) {
+    buttons = pressed;
+}
+
+uint16_t InputDevice::Buttons() const {
+    return buttons;
+}
+
+/* Lives at the start of a game, 3 to 6. Returns false for other counts */
+bool InputDevice::SetLives(int lives) {
+    if (lives < 3 || lives > 6)
+        return false;
+    dipSwitches = (dipSwitches & ~livesMask) | static_cast<uint8_t>(lives - 3);
+    return true;
+}
+
+/* Score giving the extra life, 1000 or 1500. Returns false for other scores */
+bool InputDevice::SetExtraLife(int score) {
+    if (score != 1000 && score != 1500)
+        return false;
+    dipSwitches = score == 1000 ? dipSwitches | extraLife1000 : dipSwitches & ~extraLife1000;
+    return true;
+}
+
+void InputDevice::SetCoinInfo(bool shown) {
+    dipSwitches = shown ? dipSwitches & ~coinInfoHidden : dipSwitches | coinInfoHidden;
+}
+
+/* Value of input port 0, 1 or 2. Port 0 is not read by the game, it mirrors the player one controls */
+uint8_t InputDevice::Read(uint8_t port) const {
+    switch (port) {
+        case 0:
+            return 0x0E | bit(buttons, Fire1, 4) | bit(buttons, Left1, 5) | bit(buttons, Right1, 6);
+        case 1:
+            return 0x08 | bit(buttons, Coin, 0) | bit(buttons, Start2, 1) | bit(buttons, Start1, 2) |
+                   bit(buttons, Fire1, 4) | bit(buttons, Left1, 5) | bit(buttons, Right1, 6);
+        case 2:
+            return dipSwitches | bit(buttons, Tilt, 2) | bit(buttons, Fire2, 4) | bit(buttons, Left2, 5) |
+                   bit(buttons, Right2, 6);
+        default:
+            return 0;
+    }
+}
+
+/* Button named as in the input scripts, coin, start1, fire1, left2... */
+bool InputDevice::ButtonByName(const char* name, Button& button) {
+    for (const NamedButton& named : buttonNames) {
+        if (strcmp(named.name, name) == 0) {
+            button = named.button;
+            return true;
+        }
+    }
+    return false;
+}
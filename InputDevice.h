@@ -0,0 +1,60 @@
+#ifndef INPUTDEVICE_H
+#define INPUTDEVICE_H
+
+#include <cstdint>
+
+/* The controls and DIP switches of Space Invaders, read through input ports 0, 1 and 2.
+ *
+ * Buttons are pressed and released through the API, or by a source polled at the start of every
+ * frame (a keyboard, a script, a bot), so the state seen by the game only changes between frames
+ * and a run driven by a script plays out the same every time */
+class InputDevice
+{
+public:
+    enum Button : uint16_t
+    {
+        Coin = 1 << 0,
+        Start1 = 1 << 1,
+        Start2 = 1 << 2,
+        Fire1 = 1 << 3,
+        Left1 = 1 << 4,
+        Right1 = 1 << 5,
+        Fire2 = 1 << 6,
+        Left2 = 1 << 7,
+        Right2 = 1 << 8,
+        Tilt = 1 << 9
+    };
+
+    static constexpr int buttonCount = 10;
+
+    /* Called with the frame about to run, before the game can read the ports */
+    using SourceHandler = void (*)(void* context, uint64_t frame, InputDevice& device);
+
+    InputDevice();
+
+    void SetSource(SourceHandler handler, void* context);
+    void Poll(uint64_t frame);
+
+    void Press(Button button);
+    void Release(Button button);
+    void SetButtons(uint16_t buttons);
+    uint16_t Buttons() const;
+
+    bool SetLives(int lives);
+    bool SetExtraLife(int score);
+    void SetCoinInfo(bool shown);
+
+    uint8_t Read(uint8_t port) const;
+
+    static bool ButtonByName(const char* name, Button& button);
+
+private:
+    SourceHandler source;
+    void* context;
+    uint64_t polledFrame;
+
+    uint16_t buttons;
+    uint8_t dipSwitches;
+};
+
+#endif
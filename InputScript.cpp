@@ -0,0 +1,96 @@
+#include "InputScript.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+
+InputScript::InputScript() : next(0), lastFrame(0), errorLine(0)
+{ }
+
+/* Add the events of a script file. Returns false when it cannot be read or a line is not an event,
+ * ErrorLine tells which one */
+bool InputScript::Load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file)
+        return false;
+
+    std::string line;
+    size_t number = 0;
+    while (std::getline(file, line)) {
+        ++number;
+        if (!parseLine(line)) {
+            errorLine = number;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool InputScript::parseLine(const std::string& line) {
+    std::string text = line.substr(0, line.find('#'));
+    if (text.find_first_not_of(" \t\r") == std::string::npos)
+        return true;
+
+    std::istringstream words(text);
+    uint64_t frame;
+    std::string action;
+    std::string name;
+    if (!(words >> frame >> action >> name))
+        return false;
+
+    InputDevice::Button button;
+    if (!InputDevice::ButtonByName(name.c_str(), button))
+        return false;
+
+    if (action == "press" || action == "release")
+        Add(frame, button, action == "press");
+    else if (action == "tap") {
+        uint64_t frames = 5;
+        std::string count;
+        if (words >> count) {
+            frames = strtoull(count.c_str(), nullptr, 10);
+            if (frames == 0 || count.find_first_not_of("0123456789") != std::string::npos)
+                return false;
+        }
+        Add(frame, button, true);
+        Add(frame + frames, button, false);
+    }
+    else
+        return false;
+
+    std::string rest;
+    return !(words >> rest);
+}
+
+/* Events of the same frame keep the order they were added in */
+void InputScript::Add(uint64_t frame, InputDevice::Button button, bool pressed) {
+    Event event { frame, button, pressed };
+    auto position = std::upper_bound(events.begin(), events.end(), event,
+                                     [](const Event& x, const Event& y) { return x.frame < y.frame; });
+    events.insert(position, event);
+}
+
+size_t InputScript::ErrorLine() const {
+    return errorLine;
+}
+
+/* SourceHandler applying the events up to the frame. A frame earlier than the last one, as with a
+ * machine started over, replays the script from its beginning */
+void InputScript::Poll(void* context, uint64_t frame, InputDevice& device) {
+    auto* script = static_cast<InputScript*>(context);
+    if (frame < script->lastFrame) {
+        script->next = 0;
+        device.SetButtons(0);
+    }
+    script->lastFrame = frame;
+
+    while (script->next < script->events.size() && script->events[script->next].frame <= frame) {
+        const Event& event = script->events[script->next++];
+        if (event.pressed)
+            device.Press(event.button);
+        else
+            device.Release(event.button);
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef INPUTSCRIPT_H
+#define INPUTSCRIPT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "InputDevice.h"
+
+/* Input source replaying button presses at fixed frames. A script has one event per line:
+ *   <frame> press <button>
+ *   <frame> release <button>
+ *   <frame> tap <button> [frames]    pressed for the given frames, 5 by default
+ * with the buttons named as in InputDevice::ButtonByName, and # starting a comment */
+class InputScript
+{
+public:
+    InputScript();
+
+    bool Load(const std::string& path);
+    void Add(uint64_t frame, InputDevice::Button button, bool pressed);
+    size_t ErrorLine() const;
+
+    static void Poll(void* context, uint64_t frame, InputDevice& device);
+
+private:
+    struct Event
+    {
+        uint64_t frame;
+        InputDevice::Button button;
+        bool pressed;
+    };
+
+    bool parseLine(const std::string& line);
+
+private:
+    std::vector<Event> events;
+    size_t next;
+    uint64_t lastFrame;
+    size_t errorLine;
+};
+
+#endif
@@ -0,0 +1,87 @@
+#include "KeyboardInput.h"
+
+#include <unistd.h>
+
+
+KeyboardInput::KeyboardInput() : open(false), saved(), escape(0), heldUntil()
+{ }
+
+KeyboardInput::~KeyboardInput() {
+    Close();
+}
+
+/* Switch the terminal on standard input to unbuffered reads without echo, signals are left on.
+ * Returns false when standard input is not a terminal */
+bool KeyboardInput::Open() {
+    if (open)
+        return true;
+    if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &saved) != 0)
+        return false;
+
+    struct termios raw = saved;
+    raw.c_lflag &= ~(ICANON | ECHO);
+    raw.c_cc[VMIN] = 0;
+    raw.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSANOW, &raw) != 0)
+        return false;
+    open = true;
+    return true;
+}
+
+/* Give the terminal its settings back */
+void KeyboardInput::Close() {
+    if (!open)
+        return;
+    tcsetattr(STDIN_FILENO, TCSANOW, &saved);
+    open = false;
+}
+
+/* Arrow keys arrive as ESC [ C and ESC [ D, escape counts the bytes of the sequence seen so far */
+void KeyboardInput::press(char key, uint64_t frame) {
+    if (escape == 1) {
+        escape = key == '[' ? 2 : 0;
+        return;
+    }
+    if (escape == 2) {
+        escape = 0;
+        key = key == 'D' ? 'a' : key == 'C' ? 'd' : 0;
+    }
+
+    int button;
+    switch (key) {
+        case 27: escape = 1; return;
+        case 'c': button = 0; break;
+        case '1': button = 1; break;
+        case '2': button = 2; break;
+        case ' ': button = 3; break;
+        case 'a': button = 4; break;
+        case 'd': button = 5; break;
+        case 'k': button = 6; break;
+        case 'j': button = 7; break;
+        case 'l': button = 8; break;
+        case 't': button = 9; break;
+        default: return;
+    }
+    heldUntil[button] = frame + holdFrames;
+}
+
+/* SourceHandler taking the keys typed since the last frame */
+void KeyboardInput::Poll(void* context, uint64_t frame, InputDevice& device) {
+    auto* keyboard = static_cast<KeyboardInput*>(context);
+    if (keyboard->open) {
+        char keys[64];
+        ssize_t count;
+        while ((count = read(STDIN_FILENO, keys, sizeof(keys))) > 0) {
+            for (ssize_t i = 0; i < count; i++)
+                keyboard->press(keys[i], frame);
+        }
+    }
+
+    /* heldUntil is indexed by the bit of the button in InputDevice::Button */
+    uint16_t buttons = 0;
+    for (int button = 0; button < InputDevice::buttonCount; button++) {
+        if (keyboard->heldUntil[button] > frame)
+            buttons |= 1 << button;
+    }
+    device.SetButtons(buttons);
+}
@@ -0,0 +1,40 @@
+#ifndef KEYBOARDINPUT_H
+#define KEYBOARDINPUT_H
+
+#include <cstdint>
+
+#include <termios.h>
+
+#include "InputDevice.h"
+
+/* Input source reading the keys typed in the terminal, without echo or waiting for a line.
+ * A terminal only reports presses, so a key holds its button for a few frames and the key
+ * repeat of a held key keeps it pressed.
+ *   c coin, 1 and 2 start, space fire, a/d or the arrows left and right for player one,
+ *   k fire, j and l left and right for player two, t tilt */
+class KeyboardInput
+{
+public:
+    static constexpr uint64_t holdFrames = 10;
+
+    KeyboardInput();
+    KeyboardInput(const KeyboardInput&) = delete;
+    KeyboardInput& operator=(const KeyboardInput&) = delete;
+    ~KeyboardInput();
+
+    bool Open();
+    void Close();
+
+    static void Poll(void* context, uint64_t frame, InputDevice& device);
+
+private:
+    void press(char key, uint64_t frame);
+
+private:
+    bool open;
+    struct termios saved;
+    int escape;
+    uint64_t heldUntil[InputDevice::buttonCount];
+};
+
+#endif
@@ -0,0 +1,178 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "InputScript.h"
+#include "SpaceInvaders.h"
+
+/* Peak resident set size of the process in KiB */
+static long peakRssKiB() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return static_cast<long>(counters.PeakWorkingSetSize / 1024);
+#else
+    struct rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+#endif
+}
+
+/* Escape backslashes and quotes, Windows paths included */
+static std::string jsonString(const std::string& text) {
+    std::string escaped;
+    for (char ch : text) {
+        if (ch == '\\' || ch == '"')
+            escaped += '\\';
+        escaped += ch;
+    }
+    return escaped;
+}
+
+/* Run the same frames again with the profiler attached, counting the opcodes.
+ * Kept apart from the timed run, so the histogram does not slow it down. The script replays
+ * from its start and the idle loops are skipped as in the timed run, so both runs see the same
+ * input and the counts are of the instructions the timed run executed */
+static std::array<uint64_t, 256> instructionMix(const std::string& path, long frames, InputScript* script,
+                                                bool idleSkip) {
+    SpaceInvaders<ProfilePolicies> machine;
+    machine.LoadRom(path);
+    machine.Cpu().SetIdleSkip(idleSkip);
+    if (script)
+        machine.Input().SetSource(InputScript::Poll, script);
+
+    Profiler8080 profiler;
+    machine.Cpu().SetProfiler(&profiler);
+    for (long i = 0; i < frames; i++)
+        machine.RunFrame();
+
+    std::array<uint64_t, 256> mix {};
+    for (int opCode = 0; opCode < 256; opCode++)
+        mix[opCode] = profiler.OpCodeCount(opCode);
+    return mix;
+}
+
+static void writeJson(FILE* out, const std::string& label, const std::string& path, long frames,
+                      double hostSeconds, uint64_t cycles, uint64_t skippedCycles, long peakRss,
+                      const std::array<uint64_t, 256>& mix) {
+    double emulatedSeconds = static_cast<double>(frames) / SpaceInvaders<>::framesPerSecond;
+    uint64_t instructions = 0;
+    for (uint64_t count : mix)
+        instructions += count;
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"label\": \"%s\",\n", jsonString(label).c_str());
+    fprintf(out, "  \"rom\": \"%s\",\n", jsonString(path).c_str());
+    fprintf(out, "  \"frames\": %ld,\n", frames);
+    fprintf(out, "  \"emulated_seconds\": %.6f,\n", emulatedSeconds);
+    fprintf(out, "  \"host_seconds\": %.6f,\n", hostSeconds);
+    fprintf(out, "  \"host_seconds_per_emulated_second\": %.6f,\n", hostSeconds / emulatedSeconds);
+    fprintf(out, "  \"speedup\": %.2f,\n", emulatedSeconds / hostSeconds);
+    fprintf(out, "  \"cycles\": %llu,\n", static_cast<unsigned long long>(cycles));
+    fprintf(out, "  \"skipped_cycles\": %llu,\n", static_cast<unsigned long long>(skippedCycles));
+    fprintf(out, "  \"instructions\": %llu,\n", static_cast<unsigned long long>(instructions));
+    fprintf(out, "  \"mips\": %.2f,\n", instructions / hostSeconds / 1e6);
+    fprintf(out, "  \"peak_rss_kib\": %ld,\n", peakRss);
+
+    /* Opcodes ordered from the most executed, unused ones left out */
+    std::vector<int> opCodes;
+    for (int opCode = 0; opCode < 256; opCode++) {
+        if (mix[opCode])
+            opCodes.push_back(opCode);
+    }
+    std::sort(opCodes.begin(), opCodes.end(), [&mix](int x, int y) { return mix[x] > mix[y]; });
+
+    fprintf(out, "  \"instruction_mix\": [");
+    for (size_t i = 0; i < opCodes.size(); i++) {
+        fprintf(out, "%s\n    {\"opcode\": \"0x%02X\", \"count\": %llu, \"share\": %.6f}", i ? "," : "",
+                opCodes[i], static_cast<unsigned long long>(mix[opCodes[i]]),
+                static_cast<double>(mix[opCodes[i]]) / instructions);
+    }
+    fprintf(out, "\n  ]\n}\n");
+}
+
+int main(int argc, char* argv[]) {
+    std::string path;
+    std::string jsonPath;
+    std::string label;
+    long seconds = 60;
+    bool idleSkip = false;
+    std::string inputPath;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--seconds" && i + 1 < argc)
+            seconds = std::stol(argv[++i]);
+        else if (arg == "--json" && i + 1 < argc)
+            jsonPath = argv[++i];
+        else if (arg == "--label" && i + 1 < argc)
+            label = argv[++i];
+        else if (arg == "--idle-skip")
+            idleSkip = true;
+        else if (arg == "--input" && i + 1 < argc)
+            inputPath = argv[++i];
+        else if (path.empty() && arg[0] != '-')
+            path = arg;
+        else {
+            path.clear();
+            break;
+        }
+    }
+    if (path.empty()) {
+        fprintf(stderr, "Usage: %s <rom> [--seconds N] [--json FILE] [--label TEXT] [--idle-skip]"
+                " [--input FILE]\n", argv[0]);
+        return 1;
+    }
+
+    SpaceInvaders<> machine;
+    if (!machine.LoadRom(path)) {
+        fprintf(stderr, "Error: file not found\n");
+        return 1;
+    }
+    machine.Cpu().SetIdleSkip(idleSkip);
+
+    InputScript script;
+    if (!inputPath.empty()) {
+        if (!script.Load(inputPath)) {
+            fprintf(stderr, "Error: cannot read %s, line %zu\n", inputPath.c_str(), script.ErrorLine());
+            return 1;
+        }
+        machine.Input().SetSource(InputScript::Poll, &script);
+    }
+
+    long frames = seconds * SpaceInvaders<>::framesPerSecond;
+    auto begin = std::chrono::steady_clock::now();
+    for (long i = 0; i < frames; i++)
+        machine.RunFrame();
+    auto end = std::chrono::steady_clock::now();
+    double hostSeconds = std::chrono::duration<double>(end - begin).count();
+    long peakRss = peakRssKiB();
+
+    std::array<uint64_t, 256> mix = instructionMix(path, frames, inputPath.empty() ? nullptr : &script, idleSkip);
+
+    FILE* out = stdout;
+    if (!jsonPath.empty()) {
+        out = fopen(jsonPath.c_str(), "w");
+        if (!out) {
+            fprintf(stderr, "Error: cannot write %s\n", jsonPath.c_str());
+            return 1;
+        }
+    }
+    writeJson(out, label, path, frames, hostSeconds, machine.Cpu().Cycles(), machine.Cpu().SkippedCycles(), peakRss,
+              mix);
+    if (out != stdout)
+        fclose(out);
+
+    return 0;
+}
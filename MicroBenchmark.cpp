@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Emulator8080.h"
+
+/* Every stream is a block of instructions starting at loopStart, closed by a JMP back to it */
+static constexpr uint16_t loopStart = 0x0100;
+static constexpr uint16_t subroutine = 0x8000;
+static constexpr uint16_t stackTop = 0xF000;
+static constexpr int blockBytes = 768;
+
+/* One instruction of the stream and the number of instructions running it executes, more than
+ * one when it calls a subroutine */
+struct Emitted
+{
+    std::vector<uint8_t> bytes;
+    int executed;
+};
+
+/* Emit one instruction of the stream at the given address */
+using Emitter = std::function<Emitted(uint16_t address, int index)>;
+
+struct Stream
+{
+    const char* name;
+    std::vector<uint8_t> setup;
+    Emitter emit;
+};
+
+struct Result
+{
+    double nsPerInstruction;
+    double cyclesPerInstruction;
+};
+
+static std::vector<uint8_t> jumpTo(uint8_t opCode, uint16_t address) {
+    return { opCode, static_cast<uint8_t>(address & 0xFF), static_cast<uint8_t>(address >> 8) };
+}
+
+/* Cycle through the given opcodes, one byte each */
+static Emitter cycleOpCodes(std::vector<uint8_t> opCodes) {
+    return [opCodes](uint16_t, int index) {
+        return Emitted{ { opCodes[index % opCodes.size()] }, 1 };
+    };
+}
+
+static std::vector<Stream> streams() {
+    /* LXI SP; LXI B; LXI D; LXI H; ORI 1 (clears Z and CY) */
+    std::vector<uint8_t> registers = {
+        0x31, stackTop & 0xFF, stackTop >> 8,
+        0x01, 0x34, 0x12,
+        0x11, 0x78, 0x56,
+        0x21, 0x00, 0x40,
+        0xF6, 0x01
+    };
+
+    return {
+        { "MOV", registers, cycleOpCodes({ 0x41, 0x53, 0x6A, 0x78, 0x4F, 0x5C, 0x45, 0x7E }) },
+        { "ALU", registers, cycleOpCodes({ 0x80, 0x89, 0x92, 0x9B, 0xA4, 0xAD, 0xB7, 0xB8, 0x86 }) },
+        { "INR/DCR", registers, cycleOpCodes({ 0x04, 0x0D, 0x14, 0x1D, 0x24, 0x2D, 0x3C, 0x3D }) },
+        { "DAD", registers, cycleOpCodes({ 0x09, 0x19, 0x29, 0x39 }) },
+        { "PUSH/POP", registers, cycleOpCodes({ 0xC5, 0xD5, 0xE5, 0xF5, 0xF1, 0xE1, 0xD1, 0xC1 }) },
+        { "Jcc", registers, [](uint16_t address, int index) {
+            /* JNZ and JNC are taken, JZ and JC fall through, all of them land on the next instruction */
+            static const uint8_t opCodes[] = { 0xC2, 0xCA, 0xD2, 0xDA };
+            return Emitted{ jumpTo(opCodes[index % 4], address + 3), 1 };
+        } },
+        { "CALL/RET", registers, [](uint16_t, int) {
+            /* The CALL and the RET it reaches */
+            return Emitted{ jumpTo(0xCD, subroutine), 2 };
+        } },
+        { "DAA", registers, cycleOpCodes({ 0x27 }) },
+    };
+}
+
+/* Lay the stream out in memory, returns the instruction count of one pass through the loop */
+static int buildProgram(const Stream& stream, std::vector<uint8_t>& memory) {
+    std::fill(memory.begin(), memory.end(), 0);
+
+    std::vector<uint8_t> setup = stream.setup;
+    std::vector<uint8_t> jump = jumpTo(0xC3, loopStart);
+    setup.insert(setup.end(), jump.begin(), jump.end());
+    std::copy(setup.begin(), setup.end(), memory.begin());
+
+    memory[subroutine] = 0xC9; /* RET */
+
+    uint16_t address = loopStart;
+    int index = 0;
+    int executed = 0;
+    while (address < loopStart + blockBytes) {
+        Emitted instruction = stream.emit(address, index++);
+        std::copy(instruction.bytes.begin(), instruction.bytes.end(), memory.begin() + address);
+        address += instruction.bytes.size();
+        executed += instruction.executed;
+    }
+    jump = jumpTo(0xC3, loopStart);
+    std::copy(jump.begin(), jump.end(), memory.begin() + address);
+
+    return executed + 1;
+}
+
+static Result runStream(const Stream& stream, double minSeconds) {
+    std::vector<uint8_t> memory(0x10000);
+    int blockInstructions = buildProgram(stream, memory);
+
+    Emulator8080<> cpu(memory.data());
+    while (cpu.ProgramCounter() != loopStart)
+        cpu.Emulate();
+
+    /* Measure the cost of one pass in cycles */
+    uint64_t start = cpu.Cycles();
+    do {
+        cpu.Emulate();
+    } while (cpu.ProgramCounter() != loopStart);
+    uint64_t blockCycles = cpu.Cycles() - start;
+
+    /* Grow the batch until it runs long enough to be timed reliably */
+    uint64_t blocks = 1024;
+    double best = 0.0;
+    double elapsedTotal = 0.0;
+    while (elapsedTotal < minSeconds) {
+        uint64_t target = cpu.Cycles() + blocks * blockCycles;
+
+        auto begin = std::chrono::steady_clock::now();
+        cpu.RunUntil(target);
+        auto end = std::chrono::steady_clock::now();
+
+        double elapsed = std::chrono::duration<double>(end - begin).count();
+        double ns = elapsed * 1e9 / static_cast<double>(blocks * blockInstructions);
+        if (best == 0.0 || ns < best)
+            best = ns;
+
+        elapsedTotal += elapsed;
+        if (elapsed < minSeconds / 10)
+            blocks *= 2;
+    }
+
+    return { best, static_cast<double>(blockCycles) / blockInstructions };
+}
+
+int main(int argc, char* argv[]) {
+    std::string filter;
+    double minSeconds = 0.5;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc)
+            filter = argv[++i];
+        else if (arg == "--min-time" && i + 1 < argc)
+            minSeconds = std::stod(argv[++i]);
+        else {
+            fprintf(stderr, "Usage: %s [--filter NAME] [--min-time SECONDS]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    printf("%-10s %12s %12s %10s\n", "stream", "ns/instr", "MIPS", "cyc/instr");
+    for (const Stream& stream : streams()) {
+        if (!filter.empty() && std::string(stream.name).find(filter) == std::string::npos)
+            continue;
+
+        Result result = runStream(stream, minSeconds);
+        printf("%-10s %12.3f %12.1f %10.2f\n", stream.name, result.nsPerInstruction,
+               1e3 / result.nsPerInstruction, result.cyclesPerInstruction);
+    }
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include "Profiler8080.h"
+
+#include <algorithm>
+
+
+/* The whole run starts in a root frame at the reset vector that is never left */
+Profiler8080::Profiler8080() : pcCount(0x10000, 0), pcCycles(0x10000, 0), opCount(), opCycles(),
+    selfCycles(0x10000, 0), inclusiveCycles(0x10000, 0), calls(0x10000, 0), instructions(0),
+    totalCycles(0), lastSp(0)
+{
+    frames.push_back({ 0x0000, 0x10000, 0 });
+}
+
+/* CALL, its aliases DD, ED and FD, the conditional calls and RST */
+bool Profiler8080::isCall(uint8_t opCode) {
+    return opCode == 0xCD || opCode == 0xDD || opCode == 0xED || opCode == 0xFD ||
+           (opCode & 0xC7) == 0xC4 || (opCode & 0xC7) == 0xC7;
+}
+
+/* RET, its alias D9 and the conditional returns */
+bool Profiler8080::isReturn(uint8_t opCode) {
+    return opCode == 0xC9 || opCode == 0xD9 || (opCode & 0xC7) == 0xC0;
+}
+
+void Profiler8080::enter(uint16_t caller, uint16_t function, uint16_t returnSp) {
+    ++calls[function];
+    ++edges[(static_cast<uint32_t>(caller) << 16) | function];
+    frames.push_back({ function, returnSp, totalCycles });
+}
+
+/* Leave every frame the return popped, also the ones left by code manipulating the stack */
+void Profiler8080::leave(uint16_t sp) {
+    while (frames.size() > 1 && frames.back().returnSp <= sp) {
+        inclusiveCycles[frames.back().function] += totalCycles - frames.back().entryCycles;
+        frames.pop_back();
+    }
+}
+
+uint64_t Profiler8080::Instructions() const {
+    return instructions;
+}
+
+uint64_t Profiler8080::Cycles() const {
+    return totalCycles;
+}
+
+uint64_t Profiler8080::OpCodeCount(uint8_t opCode) const {
+    return opCount[opCode];
+}
+
+uint64_t Profiler8080::OpCodeCycles(uint8_t opCode) const {
+    return opCycles[opCode];
+}
+
+/* Hottest addresses, then every executed opcode, both ordered by the cycles spent */
+void Profiler8080::WriteFlatProfile(FILE* out, size_t topAddresses) const {
+    double total = totalCycles ? static_cast<double>(totalCycles) : 1.0;
+    fprintf(out, "Flat profile: %llu instructions, %llu cycles\n\n",
+            static_cast<unsigned long long>(instructions), static_cast<unsigned long long>(totalCycles));
+
+    std::vector<uint32_t> addresses;
+    for (uint32_t address = 0; address < 0x10000; address++) {
+        if (pcCount[address])
+            addresses.push_back(address);
+    }
+    std::sort(addresses.begin(), addresses.end(),
+              [this](uint32_t x, uint32_t y) { return pcCycles[x] > pcCycles[y]; });
+    addresses.resize(std::min(addresses.size(), topAddresses));
+
+    fprintf(out, "%8s %14s %14s %8s\n", "address", "count", "cycles", "%cycles");
+    for (uint32_t address : addresses) {
+        fprintf(out, "  0x%04X %14llu %14llu %7.2f%%\n", address,
+                static_cast<unsigned long long>(pcCount[address]),
+                static_cast<unsigned long long>(pcCycles[address]), 100.0 * pcCycles[address] / total);
+    }
+
+    std::vector<int> opCodes;
+    for (int opCode = 0; opCode < 256; opCode++) {
+        if (opCount[opCode])
+            opCodes.push_back(opCode);
+    }
+    std::sort(opCodes.begin(), opCodes.end(), [this](int x, int y) { return opCycles[x] > opCycles[y]; });
+
+    fprintf(out, "\n%8s %14s %14s %8s\n", "opcode", "count", "cycles", "%cycles");
+    for (int opCode : opCodes) {
+        fprintf(out, "    0x%02X %14llu %14llu %7.2f%%\n", opCode,
+                static_cast<unsigned long long>(opCount[opCode]),
+                static_cast<unsigned long long>(opCycles[opCode]), 100.0 * opCycles[opCode] / total);
+    }
+}
+
+/* Graphviz graph of the functions, labelled with their calls, self and inclusive cycles.
+ * Frames still open are charged up to now */
+void Profiler8080::WriteCallGraph(FILE* out) const {
+    std::vector<uint64_t> inclusive = inclusiveCycles;
+    for (const Frame& frame : frames)
+        inclusive[frame.function] += totalCycles - frame.entryCycles;
+
+    fprintf(out, "digraph callgraph {\n    node [shape=box];\n");
+    for (uint32_t function = 0; function < 0x10000; function++) {
+        if (!calls[function] && !selfCycles[function])
+            continue;
+        fprintf(out, "    f%04X [label=\"0x%04X\\ncalls %llu\\nself %llu\\ninclusive %llu\"];\n", function,
+                function, static_cast<unsigned long long>(calls[function]),
+                static_cast<unsigned long long>(selfCycles[function]),
+                static_cast<unsigned long long>(inclusive[function]));
+    }
+
+    std::vector<std::pair<uint32_t, uint64_t>> sorted(edges.begin(), edges.end());
+    std::sort(sorted.begin(), sorted.end());
+    for (const auto& edge : sorted) {
+        fprintf(out, "    f%04X -> f%04X [label=\"%llu\"];\n", edge.first >> 16, edge.first & 0xFFFF,
+                static_cast<unsigned long long>(edge.second));
+    }
+    fprintf(out, "}\n");
+}
@@ -0,0 +1,84 @@
+#ifndef PROFILER8080_H
+#define PROFILER8080_H
+
+#include <cstdint>
+#include <cstdio>
+#include <unordered_map>
+#include <vector>
+
+/* Execution and cycle histograms per PC and per opcode, plus a call graph built from
+ * the CALL/RST and RET instructions that were taken.
+ *
+ * Calls and returns are told by the 8080 opcodes, the undocumented aliases of CALL and RET
+ * included. The 8085 and the Z80 use those bytes for instructions of their own, so only the
+ * 8080 policies can be profiled */
+class Profiler8080
+{
+public:
+    Profiler8080();
+
+    void Record(uint16_t pc, uint8_t opCode, uint32_t cycles, uint16_t nextPc, uint16_t spBefore,
+                uint16_t spAfter);
+
+    uint64_t Instructions() const;
+    uint64_t Cycles() const;
+    uint64_t OpCodeCount(uint8_t opCode) const;
+    uint64_t OpCodeCycles(uint8_t opCode) const;
+
+    void WriteFlatProfile(FILE* out, size_t topAddresses = 50) const;
+    void WriteCallGraph(FILE* out) const;
+
+private:
+    struct Frame
+    {
+        uint16_t function;
+        uint32_t returnSp;
+        uint64_t entryCycles;
+    };
+
+    void enter(uint16_t caller, uint16_t function, uint16_t returnSp);
+    void leave(uint16_t sp);
+
+    static bool isCall(uint8_t opCode);
+    static bool isReturn(uint8_t opCode);
+
+private:
+    std::vector<uint64_t> pcCount;
+    std::vector<uint64_t> pcCycles;
+    uint64_t opCount[256];
+    uint64_t opCycles[256];
+
+    std::vector<uint64_t> selfCycles;
+    std::vector<uint64_t> inclusiveCycles;
+    std::vector<uint64_t> calls;
+    std::unordered_map<uint32_t, uint64_t> edges;
+    std::vector<Frame> frames;
+
+    uint64_t instructions;
+    uint64_t totalCycles;
+    uint16_t lastSp;
+};
+
+/* Called after every instruction, the interrupts are seen as the stack pointer moving between two of them */
+inline void Profiler8080::Record(uint16_t pc, uint8_t opCode, uint32_t cycles, uint16_t nextPc,
+                                 uint16_t spBefore, uint16_t spAfter) {
+    if (spBefore != lastSp && spBefore == static_cast<uint16_t>(lastSp - 2))
+        enter(frames.back().function, pc, lastSp);
+
+    ++pcCount[pc];
+    pcCycles[pc] += cycles;
+    ++opCount[opCode];
+    opCycles[opCode] += cycles;
+    selfCycles[frames.back().function] += cycles;
+    ++instructions;
+    totalCycles += cycles;
+
+    if (spAfter == static_cast<uint16_t>(spBefore - 2) && isCall(opCode))
+        enter(frames.back().function, nextPc, spBefore);
+    else if (spAfter == static_cast<uint16_t>(spBefore + 2) && isReturn(opCode))
+        leave(spAfter);
+
+    lastSp = spAfter;
+}
+
+#endif
@@ -0,0 +1,446 @@
+#include "Reference8080.h"
+
+
+/* Register indexes as encoded in the opcodes, 6 stands for the memory at HL */
+static constexpr int regB = 0;
+static constexpr int regC = 1;
+static constexpr int regD = 2;
+static constexpr int regE = 3;
+static constexpr int regH = 4;
+static constexpr int regL = 5;
+static constexpr int regM = 6;
+static constexpr int regA = 7;
+
+Reference8080::Reference8080(uint8_t* memory, uint16_t counter) : registers(), sp(0), pc(counter),
+    z(false), s(false), p(false), cy(false), ac(false), intEnable(false), halted(false),
+    memory(memory), cycles(0)
+{ }
+
+uint8_t Reference8080::fetch() {
+    return memory[pc++];
+}
+
+uint16_t Reference8080::fetchWord() {
+    uint8_t low = fetch();
+    return (fetch() << 8) | low;
+}
+
+uint8_t Reference8080::getRegister(int index) const {
+    if (index == regM)
+        return memory[getPair(2)];
+    return registers[index];
+}
+
+void Reference8080::setRegister(int index, uint8_t value) {
+    if (index == regM)
+        memory[getPair(2)] = value;
+    else
+        registers[index] = value;
+}
+
+/* Pairs as encoded in the opcodes: BC, DE, HL, SP */
+uint16_t Reference8080::getPair(int index) const {
+    if (index == 3)
+        return sp;
+    return (registers[index * 2] << 8) | registers[index * 2 + 1];
+}
+
+void Reference8080::setPair(int index, uint16_t value) {
+    if (index == 3) {
+        sp = value;
+        return;
+    }
+    registers[index * 2] = value >> 8;
+    registers[index * 2 + 1] = value & 0xFF;
+}
+
+void Reference8080::push(uint16_t value) {
+    memory[--sp] = value >> 8;
+    memory[--sp] = value & 0xFF;
+}
+
+uint16_t Reference8080::pop() {
+    uint8_t low = memory[sp++];
+    return (memory[sp++] << 8) | low;
+}
+
+/* Conditions as encoded in the opcodes: NZ, Z, NC, C, PO, PE, P, M */
+bool Reference8080::condition(int index) const {
+    bool flags[4] = { z, cy, p, s };
+    return flags[index >> 1] == static_cast<bool>(index & 1);
+}
+
+void Reference8080::setZSP(uint8_t value) {
+    z = value == 0;
+    s = (value & 0x80) != 0;
+
+    bool even = true;
+    for (int bit = 0; bit < 8; bit++) {
+        if (value & (1 << bit))
+            even = !even;
+    }
+    p = even;
+}
+
+/* The carries out of bit 3 and bit 7 are read from the sum of the operands */
+void Reference8080::add(uint8_t value, bool carry) {
+    uint16_t result = registers[regA] + value + carry;
+    uint16_t carries = result ^ registers[regA] ^ value;
+
+    cy = (carries & 0x100) != 0;
+    ac = (carries & 0x10) != 0;
+    registers[regA] = result & 0xFF;
+    setZSP(registers[regA]);
+}
+
+/* Subtraction adds the complement, the carry is then inverted into a borrow */
+void Reference8080::subtract(uint8_t value, bool borrow) {
+    add(~value, !borrow);
+    cy = !cy;
+}
+
+void Reference8080::compare(uint8_t value) {
+    uint8_t acc = registers[regA];
+    subtract(value, false);
+    registers[regA] = acc;
+}
+
+/* ALU operations as encoded in the opcodes: ADD, ADC, SUB, SBB, ANA, XRA, ORA, CMP */
+void Reference8080::alu(int operation, uint8_t value) {
+    uint8_t& acc = registers[regA];
+
+    switch (operation) {
+        case 0: add(value, false); break;
+        case 1: add(value, cy); break;
+        case 2: subtract(value, false); break;
+        case 3: subtract(value, cy); break;
+        case 4:
+            ac = ((acc | value) & 0x08) != 0;
+            acc &= value;
+            cy = false;
+            setZSP(acc);
+            break;
+        case 5:
+            acc ^= value;
+            cy = ac = false;
+            setZSP(acc);
+            break;
+        case 6:
+            acc |= value;
+            cy = ac = false;
+            setZSP(acc);
+            break;
+        default: compare(value); break;
+    }
+}
+
+uint8_t Reference8080::psw() const {
+    return (s << 7) | (z << 6) | (ac << 4) | (p << 2) | 0x02 | cy;
+}
+
+void Reference8080::setPsw(uint8_t value) {
+    s = (value & 0x80) != 0;
+    z = (value & 0x40) != 0;
+    ac = (value & 0x10) != 0;
+    p = (value & 0x04) != 0;
+    cy = (value & 0x01) != 0;
+}
+
+/* Execute one instruction */
+void Reference8080::Step() {
+    if (halted) {
+        cycles += 4;
+        return;
+    }
+
+    uint8_t opCode = fetch();
+    int dst = (opCode >> 3) & 7;
+    int src = opCode & 7;
+    int pair = (opCode >> 4) & 3;
+
+    /* MOV and HLT */
+    if ((opCode & 0xC0) == 0x40) {
+        if (opCode == 0x76) {
+            halted = true;
+            cycles += 7;
+            return;
+        }
+        setRegister(dst, getRegister(src));
+        cycles += (dst == regM || src == regM) ? 7 : 5;
+        return;
+    }
+
+    /* Register and memory operands of the ALU */
+    if ((opCode & 0xC0) == 0x80) {
+        alu(dst, getRegister(src));
+        cycles += src == regM ? 7 : 4;
+        return;
+    }
+
+    if ((opCode & 0xC0) == 0x00) {
+        switch (src) {
+            case 0: /* NOP and its undocumented aliases */
+                cycles += 4;
+                return;
+            case 1:
+                if (opCode & 0x08) { /* DAD */
+                    uint32_t result = getPair(2) + getPair(pair);
+                    cy = result > 0xFFFF;
+                    setPair(2, result & 0xFFFF);
+                    cycles += 10;
+                }
+                else { /* LXI */
+                    setPair(pair, fetchWord());
+                    cycles += 10;
+                }
+                return;
+            case 2:
+                switch (dst) {
+                    case 0: memory[getPair(0)] = registers[regA]; cycles += 7; break;  /* STAX B */
+                    case 1: registers[regA] = memory[getPair(0)]; cycles += 7; break;  /* LDAX B */
+                    case 2: memory[getPair(1)] = registers[regA]; cycles += 7; break;  /* STAX D */
+                    case 3: registers[regA] = memory[getPair(1)]; cycles += 7; break;  /* LDAX D */
+                    case 4: { /* SHLD */
+                        uint16_t address = fetchWord();
+                        memory[address] = registers[regL];
+                        memory[static_cast<uint16_t>(address + 1)] = registers[regH];
+                        cycles += 16;
+                        break;
+                    }
+                    case 5: { /* LHLD */
+                        uint16_t address = fetchWord();
+                        registers[regL] = memory[address];
+                        registers[regH] = memory[static_cast<uint16_t>(address + 1)];
+                        cycles += 16;
+                        break;
+                    }
+                    case 6: memory[fetchWord()] = registers[regA]; cycles += 13; break; /* STA */
+                    default: registers[regA] = memory[fetchWord()]; cycles += 13; break; /* LDA */
+                }
+                return;
+            case 3: /* INX and DCX */
+                setPair(pair, getPair(pair) + ((opCode & 0x08) ? -1 : 1));
+                cycles += 5;
+                return;
+            case 4: { /* INR */
+                uint8_t result = getRegister(dst) + 1;
+                ac = (result & 0x0F) == 0;
+                setZSP(result);
+                setRegister(dst, result);
+                cycles += dst == regM ? 10 : 5;
+                return;
+            }
+            case 5: { /* DCR */
+                uint8_t result = getRegister(dst) - 1;
+                ac = (result & 0x0F) != 0x0F;
+                setZSP(result);
+                setRegister(dst, result);
+                cycles += dst == regM ? 10 : 5;
+                return;
+            }
+            case 6: /* MVI */
+                setRegister(dst, fetch());
+                cycles += dst == regM ? 10 : 7;
+                return;
+            default: {
+                uint8_t& acc = registers[regA];
+                cycles += 4;
+                switch (dst) {
+                    case 0: cy = acc >> 7; acc = (acc << 1) | cy; break;        /* RLC */
+                    case 1: cy = acc & 1; acc = (acc >> 1) | (cy << 7); break;  /* RRC */
+                    case 2: { /* RAL */
+                        bool carry = cy;
+                        cy = acc >> 7;
+                        acc = (acc << 1) | carry;
+                        break;
+                    }
+                    case 3: { /* RAR */
+                        bool carry = cy;
+                        cy = acc & 1;
+                        acc = (acc >> 1) | (carry << 7);
+                        break;
+                    }
+                    case 4: { /* DAA */
+                        uint8_t correction = 0;
+                        bool carry = cy;
+                        if (ac || (acc & 0x0F) > 9)
+                            correction |= 0x06;
+                        if (cy || acc > 0x99) {
+                            correction |= 0x60;
+                            carry = true;
+                        }
+                        add(correction, false);
+                        cy = carry;
+                        break;
+                    }
+                    case 5: acc = ~acc; break; /* CMA */
+                    case 6: cy = true; break;  /* STC */
+                    default: cy = !cy; break;  /* CMC */
+                }
+                return;
+            }
+        }
+    }
+
+    /* Opcodes 0xC0 - 0xFF */
+    switch (src) {
+        case 0: /* Rcc */
+            if (condition(dst)) {
+                pc = pop();
+                cycles += 11;
+            }
+            else
+                cycles += 5;
+            return;
+        case 1:
+            if ((opCode & 0x08) == 0) { /* POP */
+                if (pair == 3) {
+                    uint16_t value = pop();
+                    setPsw(value & 0xFF);
+                    registers[regA] = value >> 8;
+                }
+                else
+                    setPair(pair, pop());
+                cycles += 10;
+                return;
+            }
+            switch (pair) {
+                case 0: /* RET */
+                case 1:
+                    pc = pop();
+                    cycles += 10;
+                    return;
+                case 2: /* PCHL */
+                    pc = getPair(2);
+                    cycles += 5;
+                    return;
+                default: /* SPHL */
+                    sp = getPair(2);
+                    cycles += 5;
+                    return;
+            }
+        case 2: { /* Jcc */
+            uint16_t address = fetchWord();
+            if (condition(dst))
+                pc = address;
+            cycles += 10;
+            return;
+        }
+        case 3:
+            switch (dst) {
+                case 0: /* JMP */
+                case 1:
+                    pc = fetchWord();
+                    cycles += 10;
+                    return;
+                case 2: /* OUT, no devices are attached */
+                case 3: /* IN */
+                    fetch();
+                    cycles += 10;
+                    return;
+                case 4: { /* XTHL */
+                    uint16_t top = pop();
+                    push(getPair(2));
+                    setPair(2, top);
+                    cycles += 18;
+                    return;
+                }
+                case 5: { /* XCHG */
+                    uint16_t de = getPair(1);
+                    setPair(1, getPair(2));
+                    setPair(2, de);
+                    cycles += 4;
+                    return;
+                }
+                case 6: /* DI */
+                    intEnable = false;
+                    cycles += 4;
+                    return;
+                default: /* EI */
+                    intEnable = true;
+                    cycles += 4;
+                    return;
+            }
+        case 4: { /* Ccc */
+            uint16_t address = fetchWord();
+            if (condition(dst)) {
+                push(pc);
+                pc = address;
+                cycles += 17;
+            }
+            else
+                cycles += 11;
+            return;
+        }
+        case 5:
+            if ((opCode & 0x08) == 0) { /* PUSH */
+                if (pair == 3)
+                    push((registers[regA] << 8) | psw());
+                else
+                    push(getPair(pair));
+                cycles += 11;
+            }
+            else { /* CALL and its undocumented aliases */
+                uint16_t address = fetchWord();
+                push(pc);
+                pc = address;
+                cycles += 17;
+            }
+            return;
+        case 6: /* ALU with an immediate operand */
+            alu(dst, fetch());
+            cycles += 7;
+            return;
+        default: /* RST */
+            push(pc);
+            pc = dst * 8;
+            cycles += 11;
+            return;
+    }
+}
+
+CpuState Reference8080::State() const {
+    CpuState state;
+    state.a = registers[regA];
+    state.b = registers[regB];
+    state.c = registers[regC];
+    state.d = registers[regD];
+    state.e = registers[regE];
+    state.h = registers[regH];
+    state.l = registers[regL];
+    state.sp = sp;
+    state.pc = pc;
+    state.cc.z = z;
+    state.cc.s = s;
+    state.cc.p = p;
+    state.cc.cy = cy;
+    state.cc.ac = ac;
+    state.intEnable = intEnable;
+    return state;
+}
+
+void Reference8080::SetState(const CpuState& state) {
+    registers[regA] = state.a;
+    registers[regB] = state.b;
+    registers[regC] = state.c;
+    registers[regD] = state.d;
+    registers[regE] = state.e;
+    registers[regH] = state.h;
+    registers[regL] = state.l;
+    sp = state.sp;
+    pc = state.pc;
+    z = state.cc.z;
+    s = state.cc.s;
+    p = state.cc.p;
+    cy = state.cc.cy;
+    ac = state.cc.ac;
+    intEnable = state.intEnable;
+}
+
+uint64_t Reference8080::Cycles() const {
+    return cycles;
+}
+
+bool Reference8080::Halted() const {
+    return halted;
+}
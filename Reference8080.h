@@ -0,0 +1,54 @@
+#ifndef REFERENCE8080_H
+#define REFERENCE8080_H
+
+#include <cstdint>
+
+#include "Emulator8080.h"
+
+/* Independent 8080 interpreter decoding opcodes by their bit fields, written
+ * from the data sheet. Used as the oracle the other engines are diffed against */
+class Reference8080
+{
+public:
+    explicit Reference8080(uint8_t* memory, uint16_t counter = 0);
+
+    void Step();
+
+    CpuState State() const;
+    void SetState(const CpuState& state);
+    uint64_t Cycles() const;
+    bool Halted() const;
+
+private:
+    uint8_t fetch();
+    uint16_t fetchWord();
+
+    uint8_t getRegister(int index) const;
+    void setRegister(int index, uint8_t value);
+    uint16_t getPair(int index) const;
+    void setPair(int index, uint16_t value);
+
+    void push(uint16_t value);
+    uint16_t pop();
+    bool condition(int index) const;
+
+    void setZSP(uint8_t value);
+    void add(uint8_t value, bool carry);
+    void subtract(uint8_t value, bool borrow);
+    void compare(uint8_t value);
+    void alu(int operation, uint8_t value);
+
+    uint8_t psw() const;
+    void setPsw(uint8_t value);
+
+private:
+    uint8_t registers[8];
+    uint16_t sp, pc;
+    bool z, s, p, cy, ac;
+    bool intEnable;
+    bool halted;
+    uint8_t* memory;
+    uint64_t cycles;
+};
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef SCREEN_H
+#define SCREEN_H
+
+#include <cstddef>
+#include <cstdint>
+
+/* The Space Invaders monitor is mounted on its side. The video memory holds the 224 columns of the
+ * upright 224x256 screen, 32 bytes each, every byte 8 pixels of the column read from the bottom up */
+constexpr int screenWidth = 224;
+constexpr int screenHeight = 256;
+constexpr size_t screenBytes = static_cast<size_t>(screenWidth) * screenHeight / 8;
+
+inline bool ScreenPixel(const uint8_t* videoRam, int x, int y) {
+    int bit = screenHeight - 1 - y;
+    return (videoRam[x * (screenHeight / 8) + bit / 8] >> (bit % 8)) & 1;
+}
+
+#endif
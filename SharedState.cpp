@@ -0,0 +1,178 @@
+#include "SharedState.h"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace {
+    uint8_t pswFlags(const ConditionCodes& cc) {
+        return static_cast<uint8_t>(cc.s << 7 | cc.z << 6 | cc.ac << 4 | cc.p << 2 | 0x02 | cc.cy);
+    }
+}
+
+
+SharedStateWriter::SharedStateWriter() : region(nullptr), size(0), videoAddress(0)
+{ }
+
+SharedStateWriter::~SharedStateWriter() {
+    Close();
+}
+
+/* Create the object (a name like /invaders), sized for the video memory and the RAM ranges.
+ * An object left behind by an earlier run of the same name is replaced */
+bool SharedStateWriter::Open(const std::string& objectName, uint16_t videoStart, uint16_t videoSize,
+                             const std::vector<SharedStateHeader::Range>& ranges) {
+    Close();
+    if (ranges.size() > SharedStateHeader::maxRanges)
+        return false;
+    for (const SharedStateHeader::Range& range : ranges) {
+        if (range.address + range.length > 0x10000)
+            return false;
+    }
+
+    SharedStateHeader header {};
+    header.magic = SharedStateHeader::magicValue;
+    header.version = SharedStateHeader::versionValue;
+    header.videoOffset = sizeof(SharedStateHeader);
+    header.videoSize = videoSize;
+    uint32_t offset = header.videoOffset + videoSize;
+    for (const SharedStateHeader::Range& range : ranges) {
+        header.ranges[header.rangeCount] = { range.address, range.length, offset };
+        ++header.rangeCount;
+        offset += range.length;
+    }
+    header.size = offset;
+
+    shm_unlink(objectName.c_str());
+    int descriptor = shm_open(objectName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (descriptor < 0)
+        return false;
+    if (ftruncate(descriptor, header.size) != 0) {
+        close(descriptor);
+        shm_unlink(objectName.c_str());
+        return false;
+    }
+    void* mapped = mmap(nullptr, header.size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+    if (mapped == MAP_FAILED) {
+        shm_unlink(objectName.c_str());
+        return false;
+    }
+
+    name = objectName;
+    region = static_cast<uint8_t*>(mapped);
+    size = header.size;
+    videoAddress = videoStart;
+    memcpy(region, &header, sizeof(header));
+    return true;
+}
+
+void SharedStateWriter::Close() {
+    if (!region)
+        return;
+    munmap(region, size);
+    shm_unlink(name.c_str());
+    region = nullptr;
+}
+
+/* Copy the state in under the seqlock. Readers never block the writer, they retry instead */
+void SharedStateWriter::Publish(uint64_t frame, uint64_t cycles, const CpuState& cpu, const uint8_t* memory) {
+    if (!region)
+        return;
+
+    auto* header = reinterpret_cast<SharedStateHeader*>(region);
+    uint32_t sequence = __atomic_load_n(&header->sequence, __ATOMIC_RELAXED);
+    __atomic_store_n(&header->sequence, sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    header->frame = frame;
+    header->cycles = cycles;
+    header->pc = cpu.pc;
+    header->sp = cpu.sp;
+    header->a = cpu.a;
+    header->b = cpu.b;
+    header->c = cpu.c;
+    header->d = cpu.d;
+    header->e = cpu.e;
+    header->h = cpu.h;
+    header->l = cpu.l;
+    header->flags = pswFlags(cpu.cc);
+    header->intEnable = cpu.intEnable;
+    memcpy(region + header->videoOffset, memory + videoAddress, header->videoSize);
+    for (uint32_t i = 0; i < header->rangeCount; i++) {
+        const SharedStateHeader::Range& range = header->ranges[i];
+        memcpy(region + range.offset, memory + range.address, range.length);
+    }
+
+    __atomic_store_n(&header->sequence, sequence + 2, __ATOMIC_RELEASE);
+}
+
+
+SharedStateReader::SharedStateReader() : region(nullptr), size(0)
+{ }
+
+SharedStateReader::~SharedStateReader() {
+    Close();
+}
+
+/* Map an object published by a SharedStateWriter. Returns false when there is none by that name */
+bool SharedStateReader::Open(const std::string& name) {
+    Close();
+    int descriptor = shm_open(name.c_str(), O_RDONLY, 0);
+    if (descriptor < 0)
+        return false;
+
+    struct stat status {};
+    if (fstat(descriptor, &status) != 0 || static_cast<size_t>(status.st_size) < sizeof(SharedStateHeader)) {
+        close(descriptor);
+        return false;
+    }
+    void* mapped = mmap(nullptr, status.st_size, PROT_READ, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+    if (mapped == MAP_FAILED)
+        return false;
+
+    region = static_cast<const uint8_t*>(mapped);
+    size = status.st_size;
+    auto* header = reinterpret_cast<const SharedStateHeader*>(region);
+    if (header->magic != SharedStateHeader::magicValue || header->version != SharedStateHeader::versionValue ||
+        header->size > size) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void SharedStateReader::Close() {
+    if (!region)
+        return;
+    munmap(const_cast<uint8_t*>(region), size);
+    region = nullptr;
+}
+
+/* Copy the header and everything after it, data indexed by the offsets of the header minus the
+ * header size. Retries while the writer is busy, false when it was busy on every attempt */
+bool SharedStateReader::Read(SharedStateHeader& header, std::vector<uint8_t>& data, int attempts) const {
+    if (!region)
+        return false;
+
+    auto* shared = reinterpret_cast<const SharedStateHeader*>(region);
+    for (int attempt = 0; attempt < attempts; attempt++) {
+        uint32_t before = __atomic_load_n(&shared->sequence, __ATOMIC_ACQUIRE);
+        if (before & 1)
+            continue;
+
+        memcpy(&header, region, sizeof(header));
+        data.resize(header.size - sizeof(header));
+        memcpy(data.data(), region + sizeof(header), data.size());
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&shared->sequence, __ATOMIC_RELAXED) == before)
+            return true;
+    }
+    return false;
+}
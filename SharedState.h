@@ -0,0 +1,89 @@
+#ifndef SHAREDSTATE_H
+#define SHAREDSTATE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Emulator8080.h"
+
+/* Machine state published in a POSIX shared memory object for other local processes: the header
+ * below, then the video memory, then the selected RAM ranges, at the offsets given in the header.
+ *
+ * The header's sequence is a seqlock. The writer makes it odd before changing anything and even
+ * again once done, a reader copies what it needs between two reads of the same even sequence.
+ * The layout only uses fixed-size fields, so readers in C see it the same way */
+struct SharedStateHeader
+{
+    static constexpr uint32_t magicValue = 0x53303838;   /* "880S" */
+    static constexpr uint32_t versionValue = 1;
+    static constexpr int maxRanges = 8;
+
+    struct Range
+    {
+        uint16_t address;
+        uint16_t length;
+        uint32_t offset;
+    };
+
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;
+    uint32_t sequence;    /* accessed with atomic loads and stores only */
+
+    uint64_t frame;
+    uint64_t cycles;
+    uint16_t pc;
+    uint16_t sp;
+    uint8_t a, b, c, d, e, h, l;
+    uint8_t flags;    /* as pushed by PUSH PSW */
+    uint8_t intEnable;
+    uint8_t reserved[3];
+
+    uint32_t videoOffset;
+    uint32_t videoSize;
+    uint32_t rangeCount;
+    Range ranges[maxRanges];
+};
+
+/* Creates the shared memory object and publishes into it, removing it again on Close */
+class SharedStateWriter
+{
+public:
+    SharedStateWriter();
+    SharedStateWriter(const SharedStateWriter&) = delete;
+    SharedStateWriter& operator=(const SharedStateWriter&) = delete;
+    ~SharedStateWriter();
+
+    bool Open(const std::string& name, uint16_t videoAddress, uint16_t videoSize,
+              const std::vector<SharedStateHeader::Range>& ranges);
+    void Close();
+    void Publish(uint64_t frame, uint64_t cycles, const CpuState& cpu, const uint8_t* memory);
+
+private:
+    std::string name;
+    uint8_t* region;
+    size_t size;
+    uint16_t videoAddress;
+};
+
+/* Maps a published object read-only and copies consistent snapshots out of it */
+class SharedStateReader
+{
+public:
+    SharedStateReader();
+    SharedStateReader(const SharedStateReader&) = delete;
+    SharedStateReader& operator=(const SharedStateReader&) = delete;
+    ~SharedStateReader();
+
+    bool Open(const std::string& name);
+    void Close();
+    bool Read(SharedStateHeader& header, std::vector<uint8_t>& data, int attempts = 1000) const;
+
+private:
+    const uint8_t* region;
+    size_t size;
+};
+
+#endif
@@ -0,0 +1,297 @@
+#include "SoundDevice.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+
+namespace {
+    /* Edges of the amplifier enable bit use this sound number */
+    constexpr uint8_t amplifierSound = SoundDevice::soundCount;
+    constexpr int16_t amplitude = 6000;
+    constexpr double pi = 3.14159265358979323846;
+
+    /* The output thread takes the PCM in blocks of up to a tenth of a second */
+    constexpr size_t blockSlots = 16;
+    constexpr size_t blockBytes = SoundDevice::sampleRate / 10 * 2;
+
+    void putLittle(uint8_t* out, uint32_t value, int bytes) {
+        for (int i = 0; i < bytes; i++)
+            out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+
+    uint32_t getLittle(const uint8_t* in, int bytes) {
+        uint32_t value = 0;
+        for (int i = 0; i < bytes; i++)
+            value |= static_cast<uint32_t>(in[i]) << (8 * i);
+        return value;
+    }
+
+    /* Sound number of every bit of ports 3 and 5, -1 for the bits driving no sound */
+    constexpr int port3Sounds[8] = { 0, 1, 2, 3, 9, -1, -1, -1 };
+    constexpr int port5Sounds[8] = { 4, 5, 6, 7, 8, -1, -1, -1 };
+
+    /* A square wave of the given frequency in hertz at the given time in seconds */
+    double square(double frequency, double time) {
+        return std::fmod(time * frequency, 1.0) < 0.5 ? 1.0 : -1.0;
+    }
+
+    template <class Wave>
+    std::vector<int16_t> synthesize(double seconds, Wave wave) {
+        std::vector<int16_t> samples(static_cast<size_t>(seconds * SoundDevice::sampleRate));
+        for (size_t i = 0; i < samples.size(); i++) {
+            double time = static_cast<double>(i) / SoundDevice::sampleRate;
+            samples[i] = static_cast<int16_t>(amplitude * wave(time, time / seconds));
+        }
+        return samples;
+    }
+}
+
+
+SoundDevice::SoundDevice(uint32_t cpuFrequency) : frequency(cpuFrequency), voices(), amplifier(false),
+    port3(0), port5(0), edgeCount(0), out(nullptr), samples(0)
+{
+    edges.reserve(256);
+    generateSamples();
+}
+
+SoundDevice::~SoundDevice() {
+    Close();
+}
+
+/* Stand-ins for the sample set, rough approximations of the discrete circuits */
+void SoundDevice::generateSamples() {
+    uint32_t noise = 0x1234;
+    auto white = [&noise]() {
+        noise ^= noise << 13;
+        noise ^= noise >> 17;
+        noise ^= noise << 5;
+        return (noise & 0xFFFF) / 32768.0 - 1.0;
+    };
+
+    sounds[0] = synthesize(0.1, [](double time, double) { return square(600 + 200 * std::sin(2 * pi * 10 * time), time); });
+    sounds[1] = synthesize(0.25, [&white](double, double progress) { return white() * (1 - progress); });
+    sounds[2] = synthesize(1.0, [&white](double, double progress) { return white() * (1 - progress) * (1 - progress); });
+    sounds[3] = synthesize(0.2, [](double time, double progress) { return square(800 - 600 * progress, time); });
+    for (int step = 0; step < 4; step++) {
+        double pitch = 110 - 10 * step;
+        sounds[4 + step] = synthesize(0.08, [pitch](double time, double progress) {
+            return square(pitch, time) * (1 - progress);
+        });
+    }
+    sounds[8] = synthesize(0.6, [](double time, double progress) { return square(1000 - 700 * progress, time); });
+    sounds[9] = synthesize(0.5, [](double time, double) { return std::fmod(time, 0.1) < 0.05 ? square(1200, time) : 0; });
+}
+
+/* Replace the generated samples with 0.wav to 9.wav of the directory, the ones found.
+ * Returns false when none could be loaded */
+bool SoundDevice::LoadSamples(const std::string& directory) {
+    bool loaded = false;
+    for (int sound = 0; sound < soundCount; sound++) {
+        std::vector<int16_t> samplesOfSound;
+        if (loadWav(directory + "/" + std::to_string(sound) + ".wav", samplesOfSound)) {
+            sounds[sound] = std::move(samplesOfSound);
+            loaded = true;
+        }
+    }
+    return loaded;
+}
+
+/* Start the WAV file, its sizes are filled in by Close */
+bool SoundDevice::Open(const std::string& path) {
+    Close();
+    out = fopen(path.c_str(), "wb");
+    if (!out)
+        return false;
+
+    uint8_t header[44] = { 'R', 'I', 'F', 'F', 0, 0, 0, 0, 'W', 'A', 'V', 'E', 'f', 'm', 't', ' ' };
+    putLittle(header + 16, 16, 4);
+    putLittle(header + 20, 1, 2);
+    putLittle(header + 22, 1, 2);
+    putLittle(header + 24, sampleRate, 4);
+    putLittle(header + 28, sampleRate * 2, 4);
+    putLittle(header + 32, 2, 2);
+    putLittle(header + 34, 16, 2);
+    memcpy(header + 36, "data", 4);
+    fwrite(header, 1, sizeof(header), out);
+    samples = 0;
+
+    blocks = std::make_unique<FrameQueue>(blockSlots, blockBytes);
+    writer = std::make_unique<FrameOutput>(*blocks, writeBlock, this);
+    return true;
+}
+
+void SoundDevice::Close() {
+    if (!out)
+        return;
+
+    /* The output thread writes what is still queued first */
+    writer.reset();
+    blocks.reset();
+
+    uint32_t dataSize = static_cast<uint32_t>(samples * 2);
+    uint8_t size[4];
+    putLittle(size, 36 + dataSize, 4);
+    fseek(out, 4, SEEK_SET);
+    fwrite(size, 1, 4, out);
+    putLittle(size, dataSize, 4);
+    fseek(out, 40, SEEK_SET);
+    fwrite(size, 1, 4, out);
+    fclose(out);
+    out = nullptr;
+}
+
+/* OUT to port 3 or 5, only the bits that changed are kept, timestamped with the CPU clock */
+void SoundDevice::Write(uint8_t port, uint8_t value, uint64_t cycle) {
+    uint8_t& previous = port == 3 ? port3 : port5;
+    const int* bitSounds = port == 3 ? port3Sounds : port5Sounds;
+    uint8_t changed = previous ^ value;
+    previous = value;
+
+    for (int bit = 0; changed; bit++, changed >>= 1) {
+        if (!(changed & 1))
+            continue;
+
+        bool on = (value >> bit) & 1;
+        if (port == 3 && bit == 5)
+            edges.push_back({ cycle, amplifierSound, on });
+        else if (bitSounds[bit] >= 0)
+            edges.push_back({ cycle, static_cast<uint8_t>(bitSounds[bit]), on });
+    }
+}
+
+/* A rising edge starts its sample from the beginning. Only the UFO stops on the falling edge,
+ * the other samples play to their end */
+void SoundDevice::apply(const Edge& edge) {
+    ++edgeCount;
+    if (edge.sound == amplifierSound) {
+        amplifier = edge.on;
+        return;
+    }
+
+    Voice& voice = voices[edge.sound];
+    voice.held = edge.on;
+    if (edge.on) {
+        voice.position = 0;
+        voice.playing = !sounds[edge.sound].empty();
+    }
+    else if (edge.sound == 0)
+        voice.playing = false;
+}
+
+/* Mix everything up to the given CPU clock, applying the recorded edges at their sample */
+void SoundDevice::MixFrame(uint64_t cycle) {
+    uint64_t end = cycle * sampleRate / frequency;
+    mixed.clear();
+
+    size_t next = 0;
+    for (uint64_t sample = samples; sample < end; sample++) {
+        while (next < edges.size() && edges[next].cycle * sampleRate / frequency <= sample)
+            apply(edges[next++]);
+
+        int32_t sum = 0;
+        for (int sound = 0; sound < soundCount; sound++) {
+            Voice& voice = voices[sound];
+            if (!voice.playing)
+                continue;
+
+            sum += sounds[sound][voice.position++];
+            if (voice.position == sounds[sound].size()) {
+                voice.position = 0;
+                voice.playing = sound == 0 && voice.held;
+            }
+        }
+        mixed.push_back(amplifier ? static_cast<int16_t>(std::clamp(sum, -32768, 32767)) : 0);
+    }
+    for (; next < edges.size(); next++)
+        apply(edges[next]);
+    edges.clear();
+
+    if (end > samples)
+        samples = end;
+    if (out && !mixed.empty()) {
+        /* WAV data is little-endian. The sound is never dropped, a full queue is waited for */
+        bytes.resize(mixed.size() * 2);
+        for (size_t i = 0; i < mixed.size(); i++)
+            putLittle(&bytes[2 * i], static_cast<uint16_t>(mixed[i]), 2);
+        for (size_t offset = 0; offset < bytes.size(); offset += blockBytes) {
+            while (blocks->Full())
+                std::this_thread::yield();
+            blocks->Push(&bytes[offset], std::min(blockBytes, bytes.size() - offset), cycle);
+        }
+    }
+}
+
+/* Output thread: append a block of PCM to the WAV file */
+void SoundDevice::writeBlock(void* context, const FrameQueue::Frame& block) {
+    auto* device = static_cast<SoundDevice*>(context);
+    fwrite(block.data, 1, block.size, device->out);
+}
+
+uint64_t SoundDevice::Samples() const {
+    return samples;
+}
+
+uint64_t SoundDevice::Edges() const {
+    return edgeCount;
+}
+
+/* 8 or 16-bit PCM, mono or stereo, mixed down to mono and resampled to the output rate */
+bool SoundDevice::loadWav(const std::string& path, std::vector<int16_t>& samplesOut) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file)
+        return false;
+
+    std::vector<uint8_t> data;
+    uint8_t buffer[4096];
+    size_t size;
+    while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        data.insert(data.end(), buffer, buffer + size);
+    fclose(file);
+
+    if (data.size() < 12 || memcmp(data.data(), "RIFF", 4) != 0 || memcmp(data.data() + 8, "WAVE", 4) != 0)
+        return false;
+
+    uint32_t channels = 0;
+    uint32_t rate = 0;
+    uint32_t bits = 0;
+    const uint8_t* pcm = nullptr;
+    size_t pcmSize = 0;
+    for (size_t position = 12; position + 8 <= data.size();) {
+        uint32_t chunkSize = getLittle(&data[position + 4], 4);
+        const uint8_t* chunk = &data[position + 8];
+        size_t available = std::min<size_t>(chunkSize, data.size() - position - 8);
+        if (memcmp(&data[position], "fmt ", 4) == 0 && available >= 16) {
+            if (getLittle(chunk, 2) != 1)
+                return false;
+            channels = getLittle(chunk + 2, 2);
+            rate = getLittle(chunk + 4, 4);
+            bits = getLittle(chunk + 14, 2);
+        }
+        else if (memcmp(&data[position], "data", 4) == 0) {
+            pcm = chunk;
+            pcmSize = available;
+        }
+        position += 8 + chunkSize + (chunkSize & 1);
+    }
+    if (!pcm || !channels || !rate || (bits != 8 && bits != 16))
+        return false;
+
+    size_t frameSize = channels * bits / 8;
+    size_t frames = pcmSize / frameSize;
+    size_t outFrames = static_cast<size_t>(static_cast<uint64_t>(frames) * sampleRate / rate);
+    samplesOut.resize(outFrames);
+    for (size_t i = 0; i < outFrames; i++) {
+        const uint8_t* frame = pcm + (static_cast<uint64_t>(i) * rate / sampleRate) * frameSize;
+        int32_t sum = 0;
+        for (uint32_t channel = 0; channel < channels; channel++) {
+            if (bits == 8)
+                sum += (frame[channel] - 128) << 8;
+            else
+                sum += static_cast<int16_t>(getLittle(frame + 2 * channel, 2));
+        }
+        samplesOut[i] = static_cast<int16_t>(sum / static_cast<int32_t>(channels));
+    }
+    return true;
+}
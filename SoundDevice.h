@@ -0,0 +1,83 @@
+#ifndef SOUNDDEVICE_H
+#define SOUNDDEVICE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "FrameOutput.h"
+#include "FrameQueue.h"
+
+/* The discrete sound circuits of Space Invaders, driven by the bits of output ports 3 and 5.
+ *
+ * A write only records the bits that changed, with the cycle they changed at. Once per frame the
+ * edges are turned into sample positions and the samples they trigger are mixed into 16-bit mono PCM,
+ * handed through a FrameQueue to an output thread writing the WAV file. The samples follow the usual
+ * numbering of the Space Invaders sample sets:
+ *   0 UFO (repeats while its bit is held), 1 shot, 2 player death, 3 invader death,
+ *   4-7 fleet movement, 8 UFO hit, 9 extra life
+ * and are loaded as 0.wav to 9.wav from a directory, or generated when there is none */
+class SoundDevice
+{
+public:
+    static constexpr int sampleRate = 44100;
+    static constexpr int soundCount = 10;
+
+    explicit SoundDevice(uint32_t cpuFrequency);
+    SoundDevice(const SoundDevice&) = delete;
+    SoundDevice& operator=(const SoundDevice&) = delete;
+    ~SoundDevice();
+
+    bool LoadSamples(const std::string& directory);
+    bool Open(const std::string& path);
+    void Close();
+
+    void Write(uint8_t port, uint8_t value, uint64_t cycle);
+    void MixFrame(uint64_t cycle);
+
+    uint64_t Samples() const;
+    uint64_t Edges() const;
+
+private:
+    struct Edge
+    {
+        uint64_t cycle;
+        uint8_t sound;
+        bool on;
+    };
+
+    struct Voice
+    {
+        size_t position;
+        bool playing;
+        bool held;
+    };
+
+    void generateSamples();
+    void apply(const Edge& edge);
+    static void writeBlock(void* context, const FrameQueue::Frame& block);
+    static bool loadWav(const std::string& path, std::vector<int16_t>& samples);
+
+private:
+    uint32_t frequency;
+    std::vector<int16_t> sounds[soundCount];
+    Voice voices[soundCount];
+    bool amplifier;
+
+    uint8_t port3;
+    uint8_t port5;
+    std::vector<Edge> edges;
+    uint64_t edgeCount;
+
+    FILE* out;
+    std::vector<int16_t> mixed;
+    std::vector<uint8_t> bytes;
+    uint64_t samples;
+
+    std::unique_ptr<FrameQueue> blocks;
+    std::unique_ptr<FrameOutput> writer;
+};
+
+#endif
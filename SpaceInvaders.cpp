@@ -0,0 +1,6 @@
+#include "SpaceInvaders.h"
+
+/* The policy sets used by the project are compiled once, here */
+template class SpaceInvaders<ProductionPolicies>;
+template class SpaceInvaders<ProfilePolicies>;
+template class SpaceInvaders<DebugPolicies>;
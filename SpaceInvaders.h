@@ -0,0 +1,77 @@
+#ifndef SPACEINVADERS_H
+#define SPACEINVADERS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Emulator8080.h"
+#include "InputDevice.h"
+#include "SoundDevice.h"
+
+template <class Policies = ProductionPolicies>
+class SpaceInvaders
+{
+public:
+    static constexpr int cpuFrequency = 2000000;
+    static constexpr int framesPerSecond = 60;
+    static constexpr int cyclesPerFrame = cpuFrequency / framesPerSecond;
+
+    static constexpr uint16_t videoRamStart = 0x2400;
+    static constexpr uint16_t videoRamSize = 0x1C00;
+
+    /* Everything a run depends on, the attached devices left out */
+    struct State
+    {
+        std::vector<uint8_t> memory;
+        CpuState cpu;
+        uint64_t cycles = 0;
+        uint64_t frames = 0;
+        uint64_t nextInterruptCycle = 0;
+        int nextInterrupt = 0;
+        uint16_t shiftRegister = 0;
+        uint8_t shiftOffset = 0;
+    };
+
+    SpaceInvaders();
+    SpaceInvaders(const SpaceInvaders&) = delete;
+    SpaceInvaders& operator=(const SpaceInvaders&) = delete;
+
+    bool LoadRom(const std::string& path);
+    StopReason RunFrame();
+    void SetSoundDevice(SoundDevice* device);
+
+    void SaveState(State& state) const;
+    void LoadState(const State& state);
+
+    Emulator8080<Policies>& Cpu();
+    InputDevice& Input();
+    uint8_t* Memory();
+    const uint8_t* Memory() const;
+    const uint8_t* VideoRam() const;
+    uint64_t Frames() const;
+
+private:
+    static uint8_t portIn(void* context, uint8_t port);
+    static void portOut(void* context, uint8_t port, uint8_t value);
+
+private:
+    std::vector<uint8_t> memory;
+    Emulator8080<Policies> cpu;
+    uint64_t frames;
+    uint64_t nextInterruptCycle;
+    int nextInterrupt;
+
+    uint16_t shiftRegister;
+    uint8_t shiftOffset;
+    InputDevice input;
+    SoundDevice* sound;
+};
+
+#include "SpaceInvaders.inl"
+
+extern template class SpaceInvaders<ProductionPolicies>;
+extern template class SpaceInvaders<ProfilePolicies>;
+extern template class SpaceInvaders<DebugPolicies>;
+
+#endif
@@ -0,0 +1,151 @@
+/* Definitions of the SpaceInvaders template, included by SpaceInvaders.h */
+
+#include <algorithm>
+#include <cstdio>
+
+
+template <class Policies>
+SpaceInvaders<Policies>::SpaceInvaders() : memory(0x10000, 0), cpu(memory.data()), frames(0),
+    nextInterruptCycle(cyclesPerFrame / 2), nextInterrupt(1), shiftRegister(0), shiftOffset(0),
+    input(), sound(nullptr)
+{
+    cpu.SetIOHandlers(portIn, portOut, this);
+}
+
+/* Copy the ROM image to the start of memory */
+template <class Policies>
+bool SpaceInvaders<Policies>::LoadRom(const std::string& path) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file)
+        return false;
+
+    size_t size = fread(memory.data(), 1, 0x2000, file);
+    fclose(file);
+    return size > 0;
+}
+
+/* Poll the input source, then run until the end of the video frame, raising the mid-screen (RST 1)
+ * and the VBlank (RST 2) interrupts, and mix the sound of the frame. Returns why the CPU stopped
+ * before the end of the frame, StopReason::None when it did not, the next call resumes the frame */
+template <class Policies>
+StopReason SpaceInvaders<Policies>::RunFrame() {
+    input.Poll(frames);
+    while (true) {
+        StopReason reason = cpu.RunUntil(nextInterruptCycle);
+        if (reason != StopReason::None)
+            return reason;
+        cpu.GenerateInterrupt(nextInterrupt);
+
+        if (nextInterrupt == 2) {
+            if (sound)
+                sound->MixFrame(cpu.Cycles());
+            ++frames;
+            nextInterrupt = 1;
+            nextInterruptCycle = frames * cyclesPerFrame + cyclesPerFrame / 2;
+            return StopReason::None;
+        }
+        nextInterrupt = 2;
+        nextInterruptCycle = (frames + 1) * cyclesPerFrame;
+    }
+}
+
+/* Copy the machine into the state, reusing its memory buffer after the first save */
+template <class Policies>
+void SpaceInvaders<Policies>::SaveState(State& state) const {
+    state.memory.assign(memory.begin(), memory.end());
+    state.cpu = cpu.State();
+    state.cycles = cpu.Cycles();
+    state.frames = frames;
+    state.nextInterruptCycle = nextInterruptCycle;
+    state.nextInterrupt = nextInterrupt;
+    state.shiftRegister = shiftRegister;
+    state.shiftOffset = shiftOffset;
+}
+
+/* Put the machine back where SaveState found it, the next RunFrame continues from there */
+template <class Policies>
+void SpaceInvaders<Policies>::LoadState(const State& state) {
+    std::copy(state.memory.begin(), state.memory.end(), memory.begin());
+    cpu.SetState(state.cpu);
+    cpu.SetCycles(state.cycles);
+    frames = state.frames;
+    nextInterruptCycle = state.nextInterruptCycle;
+    nextInterrupt = state.nextInterrupt;
+    shiftRegister = state.shiftRegister;
+    shiftOffset = state.shiftOffset;
+}
+
+/* Read the input ports, ports 0 to 2 the controls and DIP switches, port 3 the shift register result */
+template <class Policies>
+uint8_t SpaceInvaders<Policies>::portIn(void* context, uint8_t port) {
+    auto* machine = static_cast<SpaceInvaders<Policies>*>(context);
+
+    switch (port) {
+        case 0:
+        case 1:
+        case 2:
+            return machine->input.Read(port);
+        case 3:
+            return (machine->shiftRegister >> (8 - machine->shiftOffset)) & 0xFF;
+        default:
+            return 0;
+    }
+}
+
+/* Attach the device playing the sounds of ports 3 and 5, nullptr ignores them */
+template <class Policies>
+void SpaceInvaders<Policies>::SetSoundDevice(SoundDevice* device) {
+    sound = device;
+}
+
+/* Write the output ports, ports 2 and 4 drive the shift register, ports 3 and 5 the sound */
+template <class Policies>
+void SpaceInvaders<Policies>::portOut(void* context, uint8_t port, uint8_t value) {
+    auto* machine = static_cast<SpaceInvaders<Policies>*>(context);
+
+    switch (port) {
+        case 2:
+            machine->shiftOffset = value & 0x07;
+            break;
+        case 4:
+            machine->shiftRegister = (value << 8) | (machine->shiftRegister >> 8);
+            break;
+        case 3:
+        case 5:
+            if (machine->sound)
+                machine->sound->Write(port, value, machine->cpu.Cycles());
+            break;
+        default:
+            break;
+    }
+}
+
+template <class Policies>
+Emulator8080<Policies>& SpaceInvaders<Policies>::Cpu() {
+    return cpu;
+}
+
+template <class Policies>
+InputDevice& SpaceInvaders<Policies>::Input() {
+    return input;
+}
+
+template <class Policies>
+uint8_t* SpaceInvaders<Policies>::Memory() {
+    return memory.data();
+}
+
+template <class Policies>
+const uint8_t* SpaceInvaders<Policies>::Memory() const {
+    return memory.data();
+}
+
+template <class Policies>
+const uint8_t* SpaceInvaders<Policies>::VideoRam() const {
+    return &memory[videoRamStart];
+}
+
+template <class Policies>
+uint64_t SpaceInvaders<Policies>::Frames() const {
+    return frames;
+}
@@ -0,0 +1,105 @@
+#include "TerminalRenderer.h"
+
+
+namespace {
+    /* Braille dot bits of the pixels of a 2x4 cell, by row then column */
+    constexpr uint8_t brailleDots[4][2] = {
+        { 0x01, 0x08 },
+        { 0x02, 0x10 },
+        { 0x04, 0x20 },
+        { 0x40, 0x80 }
+    };
+
+    /* Empty, upper half, lower half and full block */
+    constexpr uint16_t halfBlocks[4] = { 0x0020, 0x2580, 0x2584, 0x2588 };
+}
+
+
+TerminalRenderer::TerminalRenderer(FILE* out, Glyphs glyphs) : out(out), glyphs(glyphs),
+    columns(glyphs == Glyphs::Braille ? screenWidth / 2 : screenWidth),
+    rows(glyphs == Glyphs::Braille ? screenHeight / 4 : screenHeight / 2),
+    cells(static_cast<size_t>(columns) * rows, 0), drawn(false), bytesWritten(0)
+{
+    output.reserve(static_cast<size_t>(columns) * rows * 4 + 64);
+}
+
+/* Leave the cursor visible below the screen */
+TerminalRenderer::~TerminalRenderer() {
+    if (drawn)
+        fprintf(out, "\x1b[%d;1H\x1b[?25h", rows + 1);
+    fflush(out);
+}
+
+uint16_t TerminalRenderer::cell(const uint8_t* videoRam, int column, int row) const {
+    if (glyphs == Glyphs::HalfBlocks) {
+        int upper = ScreenPixel(videoRam, column, 2 * row);
+        int lower = ScreenPixel(videoRam, column, 2 * row + 1);
+        return halfBlocks[upper | (lower << 1)];
+    }
+
+    uint16_t dots = 0;
+    for (int y = 0; y < 4; y++) {
+        for (int x = 0; x < 2; x++) {
+            if (ScreenPixel(videoRam, 2 * column + x, 4 * row + y))
+                dots |= brailleDots[y][x];
+        }
+    }
+    return static_cast<uint16_t>(0x2800 | dots);
+}
+
+/* UTF-8 of a character from the basic multilingual plane */
+void TerminalRenderer::appendGlyph(uint16_t code) {
+    if (code < 0x80) {
+        output += static_cast<char>(code);
+        return;
+    }
+    output += static_cast<char>(0xE0 | (code >> 12));
+    output += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+    output += static_cast<char>(0x80 | (code & 0x3F));
+}
+
+/* Write the cells that changed since the last frame with a single write. A cursor move is only
+ * needed where the changed cells are not contiguous */
+void TerminalRenderer::Render(const uint8_t* videoRam) {
+    output.clear();
+    if (!drawn)
+        output += "\x1b[?25l\x1b[2J";
+
+    int cursorRow = -1;
+    int cursorColumn = -1;
+    for (int row = 0; row < rows; row++) {
+        for (int column = 0; column < columns; column++) {
+            uint16_t code = cell(videoRam, column, row);
+            uint16_t& shown = cells[static_cast<size_t>(row) * columns + column];
+            if (drawn && code == shown)
+                continue;
+
+            if (row != cursorRow || column != cursorColumn) {
+                char move[16];
+                int size = snprintf(move, sizeof(move), "\x1b[%d;%dH", row + 1, column + 1);
+                output.append(move, static_cast<size_t>(size));
+            }
+            appendGlyph(code);
+            shown = code;
+            cursorRow = row;
+            cursorColumn = column + 1;
+        }
+    }
+    drawn = true;
+
+    if (!output.empty()) {
+        fwrite(output.data(), 1, output.size(), out);
+        fflush(out);
+        bytesWritten += output.size();
+    }
+}
+
+/* FrameOutput handler, the context is the renderer */
+void TerminalRenderer::RenderFrame(void* context, const FrameQueue::Frame& frame) {
+    if (frame.size >= screenBytes)
+        static_cast<TerminalRenderer*>(context)->Render(frame.data);
+}
+
+uint64_t TerminalRenderer::BytesWritten() const {
+    return bytesWritten;
+}
@@ -0,0 +1,50 @@
+#ifndef TERMINALRENDERER_H
+#define TERMINALRENDERER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "FrameQueue.h"
+#include "Screen.h"
+
+/* Draws the 224x256 Space Invaders screen on an ANSI terminal, either with braille characters
+ * (2x4 pixels per cell, 112x64 cells) or with half blocks (1x2 pixels per cell, 224x128 cells).
+ * Only the cells that changed since the previous frame are written, reached with cursor moves */
+class TerminalRenderer
+{
+public:
+    enum class Glyphs
+    {
+        Braille,
+        HalfBlocks
+    };
+
+    explicit TerminalRenderer(FILE* out, Glyphs glyphs = Glyphs::Braille);
+    TerminalRenderer(const TerminalRenderer&) = delete;
+    TerminalRenderer& operator=(const TerminalRenderer&) = delete;
+    ~TerminalRenderer();
+
+    void Render(const uint8_t* videoRam);
+    static void RenderFrame(void* context, const FrameQueue::Frame& frame);
+
+    uint64_t BytesWritten() const;
+
+private:
+    uint16_t cell(const uint8_t* videoRam, int column, int row) const;
+    void appendGlyph(uint16_t code);
+
+private:
+    FILE* out;
+    Glyphs glyphs;
+    int columns;
+    int rows;
+
+    std::vector<uint16_t> cells;
+    std::string output;
+    bool drawn;
+    uint64_t bytesWritten;
+};
+
+#endif
@@ -0,0 +1,77 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+
+/* The caller of Run is one of the threads, so a pool of one starts no worker.
+ * Zero takes one thread per hardware thread */
+ThreadPool::ThreadPool(size_t threads) : task(nullptr), context(nullptr), count(0), next(0), busy(0),
+    generation(0), stopping(false)
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t i = 1; i < threads; i++)
+        workers.emplace_back(&ThreadPool::work, this);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers)
+        worker.join();
+}
+
+/* Call the task for every index below count and return once all of them are done */
+void ThreadPool::Run(size_t loopCount, Task loopTask, void* loopContext) {
+    if (workers.empty() || loopCount <= 1) {
+        for (size_t i = 0; i < loopCount; i++)
+            loopTask(loopContext, i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        task = loopTask;
+        context = loopContext;
+        count = loopCount;
+        next.store(0);
+        busy = workers.size();
+        ++generation;
+    }
+    wake.notify_all();
+    drain();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this]() { return busy == 0; });
+}
+
+size_t ThreadPool::Threads() const {
+    return workers.size() + 1;
+}
+
+void ThreadPool::work() {
+    uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this, seen]() { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+        }
+        drain();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busy == 0)
+            finished.notify_one();
+    }
+}
+
+void ThreadPool::drain() {
+    size_t index;
+    while ((index = next.fetch_add(1)) < count)
+        task(context, index);
+}
@@ -0,0 +1,46 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Fixed set of worker threads running parallel loops. Run hands out the indices of a loop one at a
+ * time, so uneven work balances itself, and the calling thread works through them too */
+class ThreadPool
+{
+public:
+    using Task = void (*)(void* context, size_t index);
+
+    explicit ThreadPool(size_t threads);
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ~ThreadPool();
+
+    void Run(size_t count, Task task, void* context);
+    size_t Threads() const;
+
+private:
+    void work();
+    void drain();
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+
+    Task task;
+    void* context;
+    size_t count;
+    std::atomic<size_t> next;
+    size_t busy;
+    uint64_t generation;
+    bool stopping;
+};
+
+#endif
@@ -0,0 +1,17 @@
+#include <cstdio>
+
+#include "VideoRecorder.h"
+
+/* Converts a recording in the intermediate format to a Y4M stream */
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s <recording> <output.y4m>\n", argv[0]);
+        return 1;
+    }
+
+    if (!VideoRecorder::ConvertToY4m(argv[1], argv[2])) {
+        fprintf(stderr, "Error: cannot convert %s\n", argv[1]);
+        return 1;
+    }
+    return 0;
+}
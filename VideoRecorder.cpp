@@ -0,0 +1,222 @@
+#include "VideoRecorder.h"
+
+#include <cstring>
+
+
+namespace {
+    const char magic[8] = { 'I', '8', '0', '8', '0', 'V', 'I', 'D' };
+    constexpr size_t headerSize = sizeof(magic) + 8;
+
+    void putWord(uint8_t* out, uint16_t value) {
+        out[0] = value & 0xFF;
+        out[1] = value >> 8;
+    }
+
+    uint16_t getWord(const uint8_t* in) {
+        return static_cast<uint16_t>(in[0] | (in[1] << 8));
+    }
+}
+
+
+VideoRecorder::VideoRecorder() : out(nullptr), format(Format::Compressed), frames(0), bytesWritten(0)
+{ }
+
+VideoRecorder::~VideoRecorder() {
+    Close();
+}
+
+bool VideoRecorder::Open(const std::string& path, Format recordFormat, int framesPerSecond) {
+    Close();
+    out = fopen(path.c_str(), "wb");
+    if (!out)
+        return false;
+
+    format = recordFormat;
+    frames = 0;
+    bytesWritten = 0;
+    previous.assign(screenBytes, 0);
+
+    if (format == Format::Y4m) {
+        writeY4mHeader(out, framesPerSecond);
+        return true;
+    }
+
+    uint8_t header[headerSize];
+    memcpy(header, magic, sizeof(magic));
+    putWord(header + 8, screenWidth);
+    putWord(header + 10, screenHeight);
+    putWord(header + 12, static_cast<uint16_t>(framesPerSecond));
+    putWord(header + 14, keyFrameInterval);
+    bytesWritten += fwrite(header, 1, sizeof(header), out);
+    return true;
+}
+
+void VideoRecorder::Close() {
+    if (out) {
+        fclose(out);
+        out = nullptr;
+    }
+}
+
+/* Append a frame of the video memory */
+bool VideoRecorder::WriteFrame(const uint8_t* videoRam) {
+    if (!out)
+        return false;
+
+    size_t written;
+    if (format == Format::Y4m) {
+        expandFrame(videoRam, luma);
+        written = fwrite("FRAME\n", 1, 6, out);
+        written += fwrite(luma.data(), 1, luma.size(), out);
+    }
+    else {
+        bool key = frames % keyFrameInterval == 0;
+        if (key)
+            encodeRuns(videoRam, screenBytes, encoded);
+        else {
+            delta.resize(screenBytes);
+            for (size_t i = 0; i < screenBytes; i++)
+                delta[i] = videoRam[i] ^ previous[i];
+            encodeRuns(delta.data(), screenBytes, encoded);
+        }
+        memcpy(previous.data(), videoRam, screenBytes);
+
+        uint8_t record[5] = { static_cast<uint8_t>(key ? 'K' : 'D') };
+        uint32_t size = static_cast<uint32_t>(encoded.size());
+        for (int i = 0; i < 4; i++)
+            record[1 + i] = static_cast<uint8_t>(size >> (8 * i));
+        written = fwrite(record, 1, sizeof(record), out);
+        written += fwrite(encoded.data(), 1, encoded.size(), out);
+    }
+
+    ++frames;
+    bytesWritten += written;
+    return !ferror(out);
+}
+
+/* FrameOutput handler, the context is the recorder */
+void VideoRecorder::RecordFrame(void* context, const FrameQueue::Frame& frame) {
+    if (frame.size >= screenBytes)
+        static_cast<VideoRecorder*>(context)->WriteFrame(frame.data);
+}
+
+/* Turn a recording in the intermediate format into a Y4M stream */
+bool VideoRecorder::ConvertToY4m(const std::string& inputPath, const std::string& outputPath) {
+    FILE* in = fopen(inputPath.c_str(), "rb");
+    if (!in)
+        return false;
+
+    uint8_t header[headerSize];
+    if (fread(header, 1, sizeof(header), in) != sizeof(header) || memcmp(header, magic, sizeof(magic)) != 0 ||
+        getWord(header + 8) != screenWidth || getWord(header + 10) != screenHeight) {
+        fclose(in);
+        return false;
+    }
+
+    FILE* out = fopen(outputPath.c_str(), "wb");
+    if (!out) {
+        fclose(in);
+        return false;
+    }
+    writeY4mHeader(out, getWord(header + 12));
+
+    std::vector<uint8_t> frame(screenBytes, 0);
+    std::vector<uint8_t> decoded(screenBytes);
+    std::vector<uint8_t> payload;
+    std::vector<uint8_t> luma;
+    bool valid = true;
+    uint8_t record[5];
+    while (fread(record, 1, sizeof(record), in) == sizeof(record)) {
+        uint32_t size = record[1] | (record[2] << 8) | (record[3] << 16) | (static_cast<uint32_t>(record[4]) << 24);
+        payload.resize(size);
+        if (fread(payload.data(), 1, size, in) != size ||
+            !decodeRuns(payload.data(), size, decoded.data(), decoded.size())) {
+            valid = false;
+            break;
+        }
+
+        for (size_t i = 0; i < screenBytes; i++)
+            frame[i] = record[0] == 'K' ? decoded[i] : frame[i] ^ decoded[i];
+        expandFrame(frame.data(), luma);
+        fwrite("FRAME\n", 1, 6, out);
+        fwrite(luma.data(), 1, luma.size(), out);
+    }
+
+    fclose(in);
+    valid = !ferror(out) && valid;
+    fclose(out);
+    return valid;
+}
+
+uint64_t VideoRecorder::Frames() const {
+    return frames;
+}
+
+uint64_t VideoRecorder::BytesWritten() const {
+    return bytesWritten;
+}
+
+/* Monochrome luma only, as the frames are black and white */
+void VideoRecorder::writeY4mHeader(FILE* out, int framesPerSecond) {
+    fprintf(out, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 Cmono\n", screenWidth, screenHeight, framesPerSecond);
+}
+
+/* One byte per pixel of the upright screen, row by row */
+void VideoRecorder::expandFrame(const uint8_t* videoRam, std::vector<uint8_t>& luma) {
+    luma.resize(static_cast<size_t>(screenWidth) * screenHeight);
+    for (int y = 0; y < screenHeight; y++) {
+        for (int x = 0; x < screenWidth; x++)
+            luma[static_cast<size_t>(y) * screenWidth + x] = ScreenPixel(videoRam, x, y) ? 235 : 16;
+    }
+}
+
+/* PackBits: a control byte below 128 is followed by that many plus one literal bytes,
+ * one of 128 and above by a single byte repeated control - 126 times */
+void VideoRecorder::encodeRuns(const uint8_t* data, size_t size, std::vector<uint8_t>& out) {
+    out.clear();
+    size_t i = 0;
+    while (i < size) {
+        size_t run = 1;
+        while (i + run < size && run < 129 && data[i + run] == data[i])
+            ++run;
+
+        if (run >= 2) {
+            out.push_back(static_cast<uint8_t>(run + 126));
+            out.push_back(data[i]);
+            i += run;
+            continue;
+        }
+
+        size_t start = i;
+        while (i < size && i - start < 128 && (i + 1 >= size || data[i + 1] != data[i]))
+            ++i;
+        if (i == start)
+            ++i;
+        out.push_back(static_cast<uint8_t>(i - start - 1));
+        out.insert(out.end(), data + start, data + i);
+    }
+}
+
+bool VideoRecorder::decodeRuns(const uint8_t* data, size_t size, uint8_t* out, size_t outSize) {
+    size_t position = 0;
+    size_t written = 0;
+    while (position < size) {
+        uint8_t control = data[position++];
+        if (control < 128) {
+            size_t count = control + 1u;
+            if (position + count > size || written + count > outSize)
+                return false;
+            memcpy(out + written, data + position, count);
+            position += count;
+            written += count;
+        }
+        else {
+            size_t count = control - 126u;
+            if (position >= size || written + count > outSize)
+                return false;
+            memset(out + written, data[position++], count);
+            written += count;
+        }
+    }
+    return written == outSize;
+}
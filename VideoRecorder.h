@@ -0,0 +1,65 @@
+#ifndef VIDEORECORDER_H
+#define VIDEORECORDER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "FrameQueue.h"
+#include "Screen.h"
+
+/* Records video memory frames, either straight to a YUV4MPEG2 stream (8-bit grayscale, upright
+ * 224x256) or to a compact intermediate format converted to Y4M afterwards.
+ *
+ * The intermediate format stores the 1 bit per pixel video memory run-length encoded. Key frames hold
+ * the memory itself and the frames between them the XOR with the previous frame, which is almost all
+ * zeros, so recording keeps up with turbo runs. The file starts with the "I8080VID" magic followed by
+ * the little-endian 16-bit width, height, frame rate and key frame interval. Every frame is a 'K' or
+ * 'D' byte, the little-endian 32-bit payload size and the payload */
+class VideoRecorder
+{
+public:
+    enum class Format
+    {
+        Y4m,
+        Compressed
+    };
+
+    static constexpr int keyFrameInterval = 600;
+
+    VideoRecorder();
+    VideoRecorder(const VideoRecorder&) = delete;
+    VideoRecorder& operator=(const VideoRecorder&) = delete;
+    ~VideoRecorder();
+
+    bool Open(const std::string& path, Format format, int framesPerSecond);
+    void Close();
+
+    bool WriteFrame(const uint8_t* videoRam);
+    static void RecordFrame(void* context, const FrameQueue::Frame& frame);
+
+    static bool ConvertToY4m(const std::string& inputPath, const std::string& outputPath);
+
+    uint64_t Frames() const;
+    uint64_t BytesWritten() const;
+
+private:
+    static void writeY4mHeader(FILE* out, int framesPerSecond);
+    static void expandFrame(const uint8_t* videoRam, std::vector<uint8_t>& luma);
+    static void encodeRuns(const uint8_t* data, size_t size, std::vector<uint8_t>& out);
+    static bool decodeRuns(const uint8_t* data, size_t size, uint8_t* out, size_t outSize);
+
+private:
+    FILE* out;
+    Format format;
+    uint64_t frames;
+    uint64_t bytesWritten;
+
+    std::vector<uint8_t> previous;
+    std::vector<uint8_t> delta;
+    std::vector<uint8_t> encoded;
+    std::vector<uint8_t> luma;
+};
+
+#endif
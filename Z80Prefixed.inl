@@ -0,0 +1,676 @@
+/* Definitions of the Z80 instructions of the Emulator8080 template, included by Emulator8080.h.
+ * The unprefixed opcodes run through the 8080 switch of Emulator8080.inl, the CB, ED, DD and FD
+ * prefixes lead here, a second switch each, so the 8080 path has no test for them */
+
+
+/* Count an opcode fetch in the low 7 bits of R, bit 7 stays as loaded */
+template <class Policies>
+inline void Emulator8080<Policies>::refresh() {
+    refreshCounter = (refreshCounter & 0x80) | ((refreshCounter + 1) & 0x7F);
+}
+
+/* JR and DJNZ, the displacement counts from the next instruction */
+template <class Policies>
+inline void Emulator8080<Policies>::jumpRelative(bool condition) {
+    if (condition) {
+        cycles += relativeTaken;
+        pc = static_cast<uint16_t>(pc + 2 + static_cast<int8_t>(instructionBytes()[1]));
+    }
+    else
+        pc += 2;
+}
+
+/* EX AF, AF' */
+template <class Policies>
+void Emulator8080<Policies>::exchangeAF() {
+    uint16_t af = (a << 8) | flagsByte();
+    a = af2 >> 8;
+    setFlagsByte(af2 & 0xFF);
+    af2 = af;
+}
+
+/* EXX, swap BC, DE and HL with the alternate set */
+template <class Policies>
+void Emulator8080<Policies>::exchangeRegisters() {
+    std::swap(bc, bc2);
+    std::swap(de, de2);
+    std::swap(hl, hl2);
+}
+
+/* Register of the 3-bit field of an opcode, B, C, D, E, H, L, -, A. 6 is memory, left to the caller */
+template <class Policies>
+inline uint8_t Emulator8080<Policies>::registerAt(int index) const {
+    switch (index) {
+        case 0:
+            return b();
+        case 1:
+            return c();
+        case 2:
+            return d();
+        case 3:
+            return e();
+        case 4:
+            return h();
+        case 5:
+            return l();
+        default:
+            return a;
+    }
+}
+
+template <class Policies>
+inline void Emulator8080<Policies>::setRegisterAt(int index, uint8_t value) {
+    switch (index) {
+        case 0:
+            setB(value);
+            break;
+        case 1:
+            setC(value);
+            break;
+        case 2:
+            setD(value);
+            break;
+        case 3:
+            setE(value);
+            break;
+        case 4:
+            setH(value);
+            break;
+        case 5:
+            setL(value);
+            break;
+        default:
+            a = value;
+            break;
+    }
+}
+
+/* Register pair of the 2-bit field of an opcode, BC, DE, HL, SP */
+template <class Policies>
+inline uint16_t Emulator8080<Policies>::pairAt(int index) const {
+    switch (index) {
+        case 0:
+            return bc;
+        case 1:
+            return de;
+        case 2:
+            return hl;
+        default:
+            return sp;
+    }
+}
+
+template <class Policies>
+inline void Emulator8080<Policies>::setPairAt(int index, uint16_t value) {
+    switch (index) {
+        case 0:
+            bc = value;
+            break;
+        case 1:
+            de = value;
+            break;
+        case 2:
+            hl = value;
+            break;
+        default:
+            sp = value;
+            break;
+    }
+}
+
+/* Accumulator operation of the 3-bit field of an opcode, ADD, ADC, SUB, SBC, AND, XOR, OR, CP */
+template <class Policies>
+void Emulator8080<Policies>::arithmetic(int operation, uint8_t value) {
+    switch (operation) {
+        case 0:
+            addRegister(value);
+            break;
+        case 1:
+            addRegisterCarry(value);
+            break;
+        case 2:
+            subtractRegister(value);
+            break;
+        case 3:
+            subtractRegisterBorrow(value);
+            break;
+        case 4:
+            logicalAndRegister(value);
+            break;
+        case 5:
+            logicalXOrRegister(value);
+            break;
+        case 6:
+            logicalOrRegister(value);
+            break;
+        default:
+            compareRegister(value);
+            break;
+    }
+}
+
+/* Rotate or shift of the CB table, RLC, RRC, RL, RR, SLA, SRA, the undocumented SLL setting bit 0,
+ * and SRL. The flags are set as by a logical operation, with the bit shifted out in the Carry */
+template <class Policies>
+uint8_t Emulator8080<Policies>::rotateShift(int operation, uint8_t value) {
+    uint8_t result;
+    uint8_t carry;
+    switch (operation) {
+        case 0:
+            carry = value >> 7;
+            result = (value << 1) | carry;
+            break;
+        case 1:
+            carry = value & 1;
+            result = (value >> 1) | (carry << 7);
+            break;
+        case 2:
+            carry = value >> 7;
+            result = (value << 1) | cc.cy;
+            break;
+        case 3:
+            carry = value & 1;
+            result = (value >> 1) | (cc.cy << 7);
+            break;
+        case 4:
+            carry = value >> 7;
+            result = value << 1;
+            break;
+        case 5:
+            carry = value & 1;
+            result = (value >> 1) | (value & 0x80);
+            break;
+        case 6:
+            carry = value >> 7;
+            result = (value << 1) | 1;
+            break;
+        default:
+            carry = value & 1;
+            result = value >> 1;
+            break;
+    }
+
+    setFlags(result);
+    cc.cy = carry;
+    cc.ac = 0;
+    cc.n = 0;
+    return result;
+}
+
+/* BIT, Zero is the inverted bit, P/V follows it, the Carry is kept */
+template <class Policies>
+void Emulator8080<Policies>::testBit(int bit, uint8_t value) {
+    uint8_t set = (value >> bit) & 1;
+    cc.z = !set;
+    cc.p = !set;
+    cc.s = bit == 7 && set;
+    cc.ac = 1;
+    cc.n = 0;
+}
+
+/* ADC HL, rr, the flags of a 16-bit addition, H the carry out of bit 11 */
+template <class Policies>
+void Emulator8080<Policies>::addPairCarry(uint16_t pair) {
+    uint32_t ans = hl + pair + cc.cy;
+
+    cc.ac = ((hl & 0xFFF) + (pair & 0xFFF) + cc.cy) > 0xFFF;
+    cc.p = ((hl ^ ~pair) & (hl ^ ans) & 0x8000) != 0;
+    cc.cy = ans > 0xFFFF;
+    cc.z = (ans & 0xFFFF) == 0;
+    cc.s = (ans >> 15) & 1;
+    cc.n = 0;
+
+    hl = ans & 0xFFFF;
+}
+
+/* SBC HL, rr, the flags of a 16-bit subtraction, H the borrow into bit 12 */
+template <class Policies>
+void Emulator8080<Policies>::subtractPairBorrow(uint16_t pair) {
+    uint16_t ans = static_cast<uint16_t>(hl - pair - cc.cy);
+
+    cc.ac = (hl & 0xFFF) < (pair & 0xFFF) + cc.cy;
+    cc.p = ((hl ^ pair) & (hl ^ ans) & 0x8000) != 0;
+    cc.cy = hl < pair + cc.cy;
+    cc.z = ans == 0;
+    cc.s = ans >> 15;
+    cc.n = 1;
+
+    hl = ans;
+}
+
+/* RLD and RRD, rotate the digits of (HL) through the low digit of the accumulator */
+template <class Policies>
+void Emulator8080<Policies>::rotateDigit(bool left) {
+    uint8_t value = readMemory(hl);
+    if (left) {
+        writeMemory(hl, (value << 4) | (a & 0x0F));
+        a = (a & 0xF0) | (value >> 4);
+    }
+    else {
+        writeMemory(hl, (a << 4) | (value >> 4));
+        a = (a & 0xF0) | (value & 0x0F);
+    }
+
+    setFlags(a);
+    cc.ac = 0;
+    cc.n = 0;
+}
+
+/* LDI and LDD, one byte from (HL) to (DE). Returns whether the repeating form goes on */
+template <class Policies>
+bool Emulator8080<Policies>::blockTransfer(int step) {
+    writeMemory(de, readMemory(hl));
+
+    hl += step;
+    de += step;
+    --bc;
+    cc.ac = 0;
+    cc.n = 0;
+    cc.p = bc != 0;
+    return bc != 0;
+}
+
+/* CPI and CPD, compare (HL) with the accumulator keeping the Carry. The repeating form goes on
+ * until a match or the end of the count */
+template <class Policies>
+bool Emulator8080<Policies>::blockCompare(int step) {
+    uint8_t value = readMemory(hl);
+    uint8_t ans = a - value;
+
+    hl += step;
+    --bc;
+    cc.s = ans >> 7;
+    cc.z = ans == 0;
+    cc.ac = (a & 0x0F) < (value & 0x0F);
+    cc.p = bc != 0;
+    cc.n = 1;
+    return bc != 0 && !cc.z;
+}
+
+/* INI and IND, port C to (HL), counting down B */
+template <class Policies>
+bool Emulator8080<Policies>::blockInput(int step) {
+    writeMemory(hl, input(c()));
+
+    hl += step;
+    setB(b() - 1);
+    cc.s = b() >> 7;
+    cc.z = b() == 0;
+    cc.n = 1;
+    return b() != 0;
+}
+
+/* OUTI and OUTD, (HL) to port C, counting down B before the write */
+template <class Policies>
+bool Emulator8080<Policies>::blockOutput(int step) {
+    uint8_t value = readMemory(hl);
+    setB(b() - 1);
+    output(c(), value);
+
+    hl += step;
+    cc.s = b() >> 7;
+    cc.z = b() == 0;
+    cc.n = 1;
+    return b() != 0;
+}
+
+/* CB table: rotates and shifts, BIT, RES and SET on a register or (HL) */
+template <class Policies>
+void Emulator8080<Policies>::executeCB() {
+    uint8_t opCode = instructionBytes()[1];
+    int group = opCode >> 6;
+    int bit = (opCode >> 3) & 7;
+    int index = opCode & 7;
+    refresh();
+
+    uint8_t value = index == 6 ? readMemory(hl) : registerAt(index);
+    if (group == 1) {
+        testBit(bit, value);
+        cycles += index == 6 ? 12 : 8;
+        pc += 2;
+        return;
+    }
+
+    if (group == 0)
+        value = rotateShift(bit, value);
+    else if (group == 2)
+        value &= ~(1 << bit);
+    else
+        value |= 1 << bit;
+
+    if (index == 6) {
+        writeMemory(hl, value);
+        cycles += 15;
+    }
+    else {
+        setRegisterAt(index, value);
+        cycles += 8;
+    }
+    pc += 2;
+}
+
+/* DD CB and FD CB table: the CB instructions on (IX+d) or (IY+d). Those writing memory also copy
+ * the result to the register of the opcode, unless it is the (HL) one */
+template <class Policies>
+void Emulator8080<Policies>::executeIndexedCB(uint16_t address, uint8_t opCode) {
+    int group = opCode >> 6;
+    int bit = (opCode >> 3) & 7;
+    int index = opCode & 7;
+
+    uint8_t value = readMemory(address);
+    if (group == 1) {
+        testBit(bit, value);
+        cycles += 20;
+        pc += 4;
+        return;
+    }
+
+    if (group == 0)
+        value = rotateShift(bit, value);
+    else if (group == 2)
+        value &= ~(1 << bit);
+    else
+        value |= 1 << bit;
+
+    writeMemory(address, value);
+    if (index != 6)
+        setRegisterAt(index, value);
+    cycles += 23;
+    pc += 4;
+}
+
+/* DD and FD tables: the instructions using HL with IX or IY in its place, (HL) becoming (IX+d) and,
+ * undocumented, H and L the halves of the index register. Returns false for the instructions that
+ * do not use HL, leaving them to run after the prefix as if it was not there */
+template <class Policies>
+bool Emulator8080<Policies>::executeIndexed(uint16_t& index) {
+    unsigned char* opCode = instructionBytes();
+    uint16_t address = static_cast<uint16_t>(index + static_cast<int8_t>(opCode[2]));
+    uint16_t word = wordAt(opCode + 2);
+
+    int target = (opCode[1] >> 3) & 7;
+    int source = opCode[1] & 7;
+
+    /* H and L in the register fields are the halves of the index */
+    auto part = [&](int field) -> uint8_t {
+        return field == 4 ? index >> 8 : field == 5 ? index & 0xFF : registerAt(field);
+    };
+    auto setPart = [&](int field, uint8_t value) {
+        if (field == 4)
+            index = (index & 0x00FF) | (value << 8);
+        else if (field == 5)
+            index = (index & 0xFF00) | value;
+        else
+            setRegisterAt(field, value);
+    };
+
+    switch (opCode[1]) {
+        case 0x09: /* ADD IX, BC */
+        case 0x19: /* ADD IX, DE */
+        case 0x29: /* ADD IX, IX */
+        case 0x39: { /* ADD IX, SP */
+            uint16_t pair = opCode[1] == 0x29 ? index : pairAt(opCode[1] >> 4);
+            uint32_t ans = index + pair;
+            cc.cy = ans > 0xFFFF;
+            cc.ac = ((index & 0xFFF) + (pair & 0xFFF)) > 0xFFF;
+            cc.n = 0;
+            index = ans & 0xFFFF;
+            cycles += 15;
+            pc += 2;
+            break;
+        }
+        case 0x21: /* LD IX, d16 */
+            index = word;
+            cycles += 14;
+            pc += 4;
+            break;
+        case 0x22: /* LD (addr), IX */
+            writeWord(word, index);
+            cycles += 20;
+            pc += 4;
+            break;
+        case 0x2A: /* LD IX, (addr) */
+            index = readWord(word);
+            cycles += 20;
+            pc += 4;
+            break;
+        case 0x23: /* INC IX */
+            ++index;
+            cycles += 10;
+            pc += 2;
+            break;
+        case 0x2B: /* DEC IX */
+            --index;
+            cycles += 10;
+            pc += 2;
+            break;
+        case 0x34: /* INC (IX+d) */
+            incrementMemory(address);
+            cycles += 23;
+            pc += 3;
+            break;
+        case 0x35: /* DEC (IX+d) */
+            decrementMemory(address);
+            cycles += 23;
+            pc += 3;
+            break;
+        case 0x36: /* LD (IX+d), d8 */
+            writeMemory(address, opCode[3]);
+            cycles += 19;
+            pc += 4;
+            break;
+        case 0xCB: /* DD CB d, opcode */
+            executeIndexedCB(address, opCode[3]);
+            break;
+        case 0xE1: /* POP IX */
+            popPair(index);
+            cycles += 14;
+            pc += 2;
+            break;
+        case 0xE3: { /* EX (SP), IX */
+            uint16_t top = readWord(sp);
+            writeWord(sp, index);
+            index = top;
+            cycles += 23;
+            pc += 2;
+            break;
+        }
+        case 0xE5: /* PUSH IX */
+            pushPair(index);
+            cycles += 15;
+            pc += 2;
+            break;
+        case 0xE9: /* JP (IX) */
+            pc = index;
+            cycles += 8;
+            break;
+        case 0xF9: /* LD SP, IX */
+            sp = index;
+            cycles += 10;
+            pc += 2;
+            break;
+
+        default:
+            if (opCode[1] >= 0x40 && opCode[1] < 0xC0 && opCode[1] != 0x76) {
+                bool load = opCode[1] < 0x80;
+                if (source == 6 || (load && target == 6)) {
+                    /* LD r, (IX+d), LD (IX+d), r and the accumulator operations on (IX+d) use
+                     * the real H and L for the register */
+                    if (!load)
+                        arithmetic(target, readMemory(address));
+                    else if (target == 6)
+                        writeMemory(address, registerAt(source));
+                    else
+                        setRegisterAt(target, readMemory(address));
+                    cycles += 19;
+                    pc += 3;
+                    break;
+                }
+                if (source == 4 || source == 5 || (load && (target == 4 || target == 5))) {
+                    if (load)
+                        setPart(target, part(source));
+                    else
+                        arithmetic(target, part(source));
+                    cycles += 8;
+                    pc += 2;
+                    break;
+                }
+            }
+            else if (opCode[1] < 0x40 && (source == 4 || source == 5 || source == 6) && (target == 4 || target == 5)) {
+                /* INC, DEC and LD of the halves */
+                if (source == 4)
+                    setPart(target, incrementRegister(part(target)));
+                else if (source == 5)
+                    setPart(target, decrementRegister(part(target)));
+                else {
+                    setPart(target, opCode[2]);
+                    cycles += 3;
+                    ++pc;
+                }
+                cycles += 8;
+                pc += 2;
+                break;
+            }
+
+            cycles += 4;
+            return false;
+    }
+
+    refresh();
+    return true;
+}
+
+/* ED table: 16-bit arithmetic and loads, I/O through port C, NEG, RETN, the interrupt modes, the I
+ * and R registers, RLD, RRD and the block instructions. The opcodes without an instruction take
+ * 8 states, or stop the run with strict opcodes on */
+template <class Policies>
+void Emulator8080<Policies>::executeED() {
+    unsigned char* opCode = instructionBytes();
+    int target = (opCode[1] >> 3) & 7;
+    int pair = (opCode[1] >> 4) & 3;
+    uint16_t word = wordAt(opCode + 2);
+    refresh();
+
+    if (opCode[1] >= 0x40 && opCode[1] < 0x80) {
+        switch (opCode[1] & 7) {
+            case 0: { /* IN r, (C), IN (C) setting only the flags */
+                uint8_t value = input(c());
+                setFlags(value);
+                cc.ac = 0;
+                cc.n = 0;
+                if (target != 6)
+                    setRegisterAt(target, value);
+                cycles += 12;
+                break;
+            }
+            case 1: /* OUT (C), r, OUT (C), 0 */
+                output(c(), target == 6 ? 0 : registerAt(target));
+                cycles += 12;
+                break;
+            case 2: /* SBC HL, rr and ADC HL, rr */
+                if (opCode[1] & 0x08)
+                    addPairCarry(pairAt(pair));
+                else
+                    subtractPairBorrow(pairAt(pair));
+                cycles += 15;
+                break;
+            case 3: /* LD (addr), rr and LD rr, (addr) */
+                if (opCode[1] & 0x08)
+                    setPairAt(pair, readWord(word));
+                else
+                    writeWord(word, pairAt(pair));
+                cycles += 20;
+                pc += 2;
+                break;
+            case 4: { /* NEG */
+                uint8_t value = a;
+                a = 0;
+                subtractRegister(value);
+                cycles += 8;
+                break;
+            }
+            case 5: /* RETN, RETI */
+                intEnable = iff2;
+                ret();
+                cycles += 14;
+                return;
+            case 6: { /* IM 0, 1, 2 */
+                static constexpr uint8_t modes[8] = { 0, 0, 1, 2, 0, 0, 1, 2 };
+                interruptMode = modes[target];
+                cycles += 8;
+                break;
+            }
+            default:
+                switch (target) {
+                    case 0: /* LD I, A */
+                        interruptVector = a;
+                        cycles += 9;
+                        break;
+                    case 1: /* LD R, A */
+                        refreshCounter = a;
+                        cycles += 9;
+                        break;
+                    case 2: /* LD A, I */
+                    case 3: /* LD A, R */
+                        a = target == 2 ? interruptVector : refreshCounter;
+                        setFlags(a);
+                        cc.p = iff2;
+                        cc.ac = 0;
+                        cc.n = 0;
+                        cycles += 9;
+                        break;
+                    case 4: /* RRD */
+                    case 5: /* RLD */
+                        rotateDigit(target == 5);
+                        cycles += 18;
+                        break;
+                    default:
+                        if (strictOpcodes) {
+                            illegalOpcode();
+                            return;
+                        }
+                        cycles += 8;
+                        break;
+                }
+                break;
+        }
+        pc += 2;
+        return;
+    }
+
+    /* LDI, CPI, INI, OUTI, the decrementing forms at +8 and the repeating ones at +16. A repeating
+     * form goes on by running itself again, so interrupts get in between the iterations */
+    if ((opCode[1] & 0xE4) == 0xA0) {
+        int step = (opCode[1] & 0x08) ? -1 : 1;
+        bool more;
+        switch (opCode[1] & 3) {
+            case 0:
+                more = blockTransfer(step);
+                break;
+            case 1:
+                more = blockCompare(step);
+                break;
+            case 2:
+                more = blockInput(step);
+                break;
+            default:
+                more = blockOutput(step);
+                break;
+        }
+
+        if ((opCode[1] & 0x10) && more)
+            cycles += 21;
+        else {
+            cycles += 16;
+            pc += 2;
+        }
+        return;
+    }
+
+    if (strictOpcodes) {
+        illegalOpcode();
+        return;
+    }
+    cycles += 8;
+    pc += 2;
+}
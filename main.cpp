@@ -1,17 +1,374 @@
 #include <iostream>
 #include <cstdio>
 #include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 #include "Emulator8080.h"
 #include "Disassembler8080.h"
+#include "FrameOutput.h"
+#include "FramePacer.h"
+#include "FrameQueue.h"
+#include "InputScript.h"
+#include "Profiler8080.h"
+#include "SpaceInvaders.h"
+#include "TerminalRenderer.h"
+#include "VideoRecorder.h"
+#ifndef _WIN32
+#include "GdbStub8080.h"
+#include "KeyboardInput.h"
+#include "SharedState.h"
+#endif
 
-int main() {
+template <class Writer>
+static bool writeProfile(const std::string& path, Writer writer) {
+    FILE* out = fopen(path.c_str(), "w");
+    if (!out) {
+        std::cerr << "Error: cannot write " << path << std::endl;
+        return false;
+    }
+    writer(out);
+    fclose(out);
+    return true;
+}
+
+/* How a headless run is driven. Without pacing it runs unthrottled and renders nothing */
+struct HeadlessOptions
+{
+    long frames = -1;
+    bool idleSkip = false;
+    bool strictOpcodes = false;
+    bool paced = false;
+    FramePacer::Mode pacing = FramePacer::Mode::RealTime;
+    int renderInterval = 1;
+    bool display = false;
+    TerminalRenderer::Glyphs glyphs = TerminalRenderer::Glyphs::Braille;
+    std::string recordPath;
+    std::string soundPath;
+    std::string samplesPath;
+    std::string inputPath;
+    bool keyboard = false;
+    int lives = 3;
+    int extraLife = 1500;
+#ifndef _WIN32
+    std::string sharedName;
+    std::vector<SharedStateHeader::Range> sharedRanges;
+#endif
+};
+
+/* Where the output thread sends the frames, the renderer only gets those the pacer picked */
+struct FrameSinks
+{
+    TerminalRenderer* renderer = nullptr;
+    VideoRecorder* recorder = nullptr;
+    uint64_t rendered = 0;
+};
+
+static const char* stopMessage(StopReason reason) {
+    switch (reason) {
+        case StopReason::Halt:
+            return "halted with interrupts disabled";
+        case StopReason::IllegalOpcode:
+            return "illegal opcode";
+        case StopReason::Fault:
+            return "device fault";
+        default:
+            return "stopped";
+    }
+}
+
+static void outputFrame(void* context, const FrameQueue::Frame& frame) {
+    auto* sinks = static_cast<FrameSinks*>(context);
+    if (frame.render) {
+        if (sinks->renderer)
+            TerminalRenderer::RenderFrame(sinks->renderer, frame);
+        ++sinks->rendered;
+    }
+    if (sinks->recorder)
+        VideoRecorder::RecordFrame(sinks->recorder, frame);
+}
+
+/* Run the Space Invaders machine headless for the given number of frames, or until killed when paced */
+template <class Policies>
+static int runHeadless(const std::string& path, const HeadlessOptions& options, Profiler8080* profiler) {
+    SpaceInvaders<Policies> machine;
+    if (!machine.LoadRom(path)) {
+        std::cerr << "Error: file not found" << std::endl;
+        return 1;
+    }
+
+    machine.Cpu().SetProfiler(profiler);
+    machine.Cpu().SetIdleSkip(options.idleSkip);
+    machine.Cpu().SetStrictOpcodes(options.strictOpcodes);
+
+    /* Buttons come from a script or the terminal, neither leaves them released */
+    if (!machine.Input().SetLives(options.lives) || !machine.Input().SetExtraLife(options.extraLife)) {
+        std::cerr << "Error: lives must be 3 to 6, the extra life at 1000 or 1500" << std::endl;
+        return 1;
+    }
+    InputScript script;
+    if (!options.inputPath.empty()) {
+        if (!script.Load(options.inputPath)) {
+            std::cerr << "Error: cannot read " << options.inputPath;
+            if (script.ErrorLine())
+                std::cerr << ", line " << script.ErrorLine();
+            std::cerr << std::endl;
+            return 1;
+        }
+        machine.Input().SetSource(InputScript::Poll, &script);
+    }
+#ifndef _WIN32
+    KeyboardInput keyboard;
+    if (options.keyboard) {
+        if (!keyboard.Open()) {
+            std::cerr << "Error: the keyboard needs a terminal" << std::endl;
+            return 1;
+        }
+        machine.Input().SetSource(KeyboardInput::Poll, &keyboard);
+    }
+#endif
+
+#ifndef _WIN32
+    /* Published after every frame, rendered or not */
+    SharedStateWriter shared;
+    if (!options.sharedName.empty() &&
+        !shared.Open(options.sharedName, SpaceInvaders<Policies>::videoRamStart, SpaceInvaders<Policies>::videoRamSize,
+                     options.sharedRanges)) {
+        std::cerr << "Error: cannot create shared memory " << options.sharedName << std::endl;
+        return 1;
+    }
+#endif
+
+    std::unique_ptr<SoundDevice> sound;
+    if (!options.soundPath.empty()) {
+        sound = std::make_unique<SoundDevice>(SpaceInvaders<Policies>::cpuFrequency);
+        if (!options.samplesPath.empty() && !sound->LoadSamples(options.samplesPath))
+            std::cerr << "Warning: no samples in " << options.samplesPath << ", using generated ones" << std::endl;
+        if (!sound->Open(options.soundPath)) {
+            std::cerr << "Error: cannot write " << options.soundPath << std::endl;
+            return 1;
+        }
+        machine.SetSoundDevice(sound.get());
+    }
+
+    /* The frames picked for rendering go to the output thread, every frame when recording, flagged with
+     * whether it is drawn */
+    std::unique_ptr<FramePacer> pacer;
+    std::unique_ptr<FrameQueue> queue;
+    std::unique_ptr<TerminalRenderer> renderer;
+    std::unique_ptr<VideoRecorder> recorder;
+    FrameSinks sinks;
+    std::unique_ptr<FrameOutput> output;
+    if (options.paced) {
+        pacer = std::make_unique<FramePacer>(options.pacing, SpaceInvaders<Policies>::cpuFrequency,
+                                             options.renderInterval);
+        queue = std::make_unique<FrameQueue>(8, SpaceInvaders<Policies>::videoRamSize);
+        if (options.display)
+            renderer = std::make_unique<TerminalRenderer>(stdout, options.glyphs);
+        if (!options.recordPath.empty()) {
+            bool y4m = options.recordPath.size() >= 4 &&
+                       options.recordPath.compare(options.recordPath.size() - 4, 4, ".y4m") == 0;
+            recorder = std::make_unique<VideoRecorder>();
+            if (!recorder->Open(options.recordPath, y4m ? VideoRecorder::Format::Y4m : VideoRecorder::Format::Compressed,
+                                SpaceInvaders<Policies>::framesPerSecond)) {
+                std::cerr << "Error: cannot write " << options.recordPath << std::endl;
+                return 1;
+            }
+        }
+        sinks.renderer = renderer.get();
+        sinks.recorder = recorder.get();
+        output = std::make_unique<FrameOutput>(*queue, outputFrame, &sinks);
+    }
+    StopReason reason = StopReason::None;
+    for (long i = 0; options.frames < 0 || i < options.frames; i++) {
+        reason = machine.RunFrame();
+        if (reason != StopReason::None)
+            break;
+#ifndef _WIN32
+        shared.Publish(machine.Frames(), machine.Cpu().Cycles(), machine.Cpu().State(), machine.Memory());
+#endif
+        if (pacer) {
+            bool render = pacer->FrameDone(machine.Cpu().Cycles());
+            if (recorder) {
+                /* A recording keeps every frame, waiting for the output thread instead of dropping */
+                while (queue->Full())
+                    std::this_thread::yield();
+                queue->Push(machine.VideoRam(), SpaceInvaders<Policies>::videoRamSize, machine.Cpu().Cycles(), render);
+            }
+            else if (render)
+                queue->Push(machine.VideoRam(), SpaceInvaders<Policies>::videoRamSize, machine.Cpu().Cycles());
+        }
+    }
+    if (output)
+        output->Stop();
+    renderer.reset();
+    if (recorder)
+        recorder->Close();
+
+    printf("%llu frames, %llu cycles\n", static_cast<unsigned long long>(machine.Frames()),
+           static_cast<unsigned long long>(machine.Cpu().Cycles()));
+    if (options.idleSkip)
+        printf("%llu cycles skipped in idle loops\n", static_cast<unsigned long long>(machine.Cpu().SkippedCycles()));
+    if (pacer) {
+        printf("%llu frames rendered, %llu late\n", static_cast<unsigned long long>(sinks.rendered),
+               static_cast<unsigned long long>(pacer->LateFrames()));
+        printf("output queue: %llu frames dropped, %llu late\n", static_cast<unsigned long long>(queue->Dropped()),
+               static_cast<unsigned long long>(queue->Late()));
+    }
+    if (recorder)
+        printf("%llu frames recorded, %llu bytes\n", static_cast<unsigned long long>(recorder->Frames()),
+               static_cast<unsigned long long>(recorder->BytesWritten()));
+    if (sound) {
+        sound->Close();
+        printf("%llu sound samples, %llu sound edges\n", static_cast<unsigned long long>(sound->Samples()),
+               static_cast<unsigned long long>(sound->Edges()));
+    }
+    if (reason != StopReason::None) {
+        fprintf(stderr, "Error: CPU %s at %04X\n", stopMessage(reason), machine.Cpu().StopAddress());
+        return 1;
+    }
+    return 0;
+}
+
+/* Headless run with the profiler compiled in, writing the requested profiles */
+static int runProfiled(const std::string& path, const HeadlessOptions& options, const std::string& profilePath,
+                       const std::string& callGraphPath) {
+    auto profiler = std::make_unique<Profiler8080>();
+    if (runHeadless<ProfilePolicies>(path, options, profiler.get()) != 0)
+        return 1;
+
+    if (!profilePath.empty() &&
+        !writeProfile(profilePath, [&profiler](FILE* out) { profiler->WriteFlatProfile(out); }))
+        return 1;
+    if (!callGraphPath.empty() &&
+        !writeProfile(callGraphPath, [&profiler](FILE* out) { profiler->WriteCallGraph(out); }))
+        return 1;
+    return 0;
+}
+
+#ifndef _WIN32
+/* Run the machine under the GDB stub, which is served between frames. Without --frames it runs
+ * until the debugger kills it */
+static int runDebugged(const std::string& path, long frames, const std::string& endpoint) {
+    SpaceInvaders<DebugPolicies> machine;
+    if (!machine.LoadRom(path)) {
+        std::cerr << "Error: file not found" << std::endl;
+        return 1;
+    }
+
+    Debugger8080 debugger;
+    machine.Cpu().SetDebugger(&debugger);
+    GdbStub8080 stub(machine.Cpu(), machine.Memory(), debugger);
+    if (!stub.Open(endpoint))
+        return 1;
+
+    while ((frames < 0 || machine.Frames() < static_cast<uint64_t>(frames)) && stub.Poll()) {
+        StopReason reason = machine.RunFrame();
+        if (reason != StopReason::None)
+            stub.ReportStop(reason);
+    }
+
+    printf("%llu frames, %llu cycles\n", static_cast<unsigned long long>(machine.Frames()),
+           static_cast<unsigned long long>(machine.Cpu().Cycles()));
+    return 0;
+}
+#endif
+
+int main(int argc, char* argv[]) {
     setvbuf(stdout, NULL, _IONBF, 0);
-    /*
-    std::cout << "File path: " << std::endl;
-    std::string path;
-    std::cin >> path;
-    */
-    std::string path = "D:\\Pobrane\\Github_projects\\Intel8080-ConsoleEmulator\\ROMS\\SpaceInvaders\\invaders.concatenated";
+
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <rom> [--frames N [--profile FILE] [--callgraph FILE]]"
+                  << " [--realtime | --turbo N] [--display braille|halfblocks] [--record FILE]"
+                  << " [--sound FILE.wav [--samples DIR]] [--input FILE | --keyboard] [--lives N]"
+                  << " [--extra-life 1000|1500] [--shm NAME [--shm-ram ADDRESS:LENGTH]...]"
+                  << " [--idle-skip] [--strict-opcodes] [--gdb PORT|unix:PATH]" << std::endl;
+        return 1;
+    }
+    std::string path = argv[1];
+
+    /* With --frames or a pacing mode the ROM runs headless, otherwise every instruction is traced */
+    HeadlessOptions options;
+    std::string profilePath;
+    std::string callGraphPath;
+    std::string gdbEndpoint;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--frames" && i + 1 < argc)
+            options.frames = std::stol(argv[++i]);
+        else if (arg == "--profile" && i + 1 < argc)
+            profilePath = argv[++i];
+        else if (arg == "--callgraph" && i + 1 < argc)
+            callGraphPath = argv[++i];
+        else if (arg == "--gdb" && i + 1 < argc)
+            gdbEndpoint = argv[++i];
+        else if (arg == "--idle-skip")
+            options.idleSkip = true;
+        else if (arg == "--strict-opcodes")
+            options.strictOpcodes = true;
+        else if (arg == "--realtime") {
+            options.paced = true;
+            options.pacing = FramePacer::Mode::RealTime;
+        }
+        else if (arg == "--turbo" && i + 1 < argc) {
+            options.paced = true;
+            options.pacing = FramePacer::Mode::Turbo;
+            options.renderInterval = std::stoi(argv[++i]);
+        }
+        else if (arg == "--display" && i + 1 < argc) {
+            std::string glyphs = argv[++i];
+            options.display = true;
+            options.glyphs = glyphs == "halfblocks" ? TerminalRenderer::Glyphs::HalfBlocks
+                                                    : TerminalRenderer::Glyphs::Braille;
+        }
+        else if (arg == "--record" && i + 1 < argc)
+            options.recordPath = argv[++i];
+        else if (arg == "--sound" && i + 1 < argc)
+            options.soundPath = argv[++i];
+        else if (arg == "--samples" && i + 1 < argc)
+            options.samplesPath = argv[++i];
+        else if (arg == "--input" && i + 1 < argc)
+            options.inputPath = argv[++i];
+        else if (arg == "--keyboard")
+            options.keyboard = true;
+        else if (arg == "--lives" && i + 1 < argc)
+            options.lives = std::stoi(argv[++i]);
+        else if (arg == "--extra-life" && i + 1 < argc)
+            options.extraLife = std::stoi(argv[++i]);
+#ifndef _WIN32
+        else if (arg == "--shm" && i + 1 < argc)
+            options.sharedName = argv[++i];
+        else if (arg == "--shm-ram" && i + 1 < argc) {
+            /* Hexadecimal with 0x, like 0x2000:0x400 */
+            std::string range = argv[++i];
+            size_t colon = range.find(':');
+            unsigned long address = std::stoul(range.substr(0, colon), nullptr, 0);
+            unsigned long length = colon == std::string::npos ? 1 : std::stoul(range.substr(colon + 1), nullptr, 0);
+            if (address + length > 0x10000 || length > 0xFFFF) {
+                std::cerr << "Error: " << range << " is outside of memory" << std::endl;
+                return 1;
+            }
+            options.sharedRanges.push_back({ static_cast<uint16_t>(address), static_cast<uint16_t>(length), 0 });
+        }
+#endif
+    }
+    /* A display or the keyboard without a pacing mode plays in real time, a recording alone runs unthrottled */
+    if (options.display || options.keyboard)
+        options.paced = true;
+    if (!options.recordPath.empty() && !options.paced) {
+        options.paced = true;
+        options.pacing = FramePacer::Mode::Turbo;
+    }
+#ifndef _WIN32
+    if (!gdbEndpoint.empty())
+        return runDebugged(path, options.frames, gdbEndpoint);
+#endif
+    bool headless = options.frames >= 0 || options.paced;
+    if (headless && (!profilePath.empty() || !callGraphPath.empty()))
+        return runProfiled(path, options, profilePath, callGraphPath);
+    if (headless)
+        return runHeadless<ProductionPolicies>(path, options, nullptr);
 
     FILE* file = fopen(path.c_str(), "rb");
     if (!file) {
@@ -30,7 +387,7 @@ int main() {
     int pc = 0;
     int line = 0;
 
-    Emulator8080 emulator(buffer);
+    Emulator8080<> emulator(buffer);
     while(emulator.ProgramCounter() < size) {
         printf("%d: ", ++line);
         disassembler(buffer, emulator.ProgramCounter());
@@ -39,4 +396,4 @@ int main() {
 
     delete[] buffer;
     return 0;
-}
\ No newline at end of file
+}
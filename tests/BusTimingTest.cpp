@@ -0,0 +1,187 @@
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Emulator8080.h"
+#include "TestSupport.h"
+
+/* Runs every opcode of the 8080 and the 8085 under a bus handler recording the machine cycles. The
+ * states of the cycles, M1 from the data sheets and 3 for every other one, and the internal states of
+ * the few instructions having them must add up to the count of the cycle tables, with the taken branch
+ * extras. Each cycle must start where the one before it ended, and the wait states the handler adds
+ * must lengthen the instruction by as much */
+
+struct BusTiming8085Policies : Intel8085Policies
+{
+    static constexpr bool busTiming = true;
+};
+
+struct BusLog
+{
+    std::vector<BusCycle> kinds;
+    std::vector<uint64_t> clocks;
+    unsigned waits = 0;
+};
+
+static constexpr int runsPerOpcode = 32;
+static constexpr uint16_t programAddress = 0x1000;
+static constexpr uint16_t operandAddress = 0x4000;
+static constexpr uint16_t stackAddress = 0x8000;
+static constexpr uint16_t returnAddress = 0x5000;
+
+static unsigned recordCycle(void* context, BusCycle cycle, uint16_t, uint8_t, uint64_t clock) {
+    auto* log = static_cast<BusLog*>(context);
+    log->kinds.push_back(cycle);
+    log->clocks.push_back(clock);
+    return log->waits;
+}
+
+static int instructionLength(uint8_t opCode) {
+    if ((opCode & 0xCF) == 0x01 || (opCode & 0xE7) == 0x22 || (opCode & 0xC7) == 0xC2 ||
+        (opCode & 0xC7) == 0xC4 || opCode == 0xC3 || opCode == 0xCB || (opCode & 0xCF) == 0xCD)
+        return 3;
+    if ((opCode & 0xC7) == 0x06 || (opCode & 0xC7) == 0xC6 || opCode == 0xD3 || opCode == 0xDB)
+        return 2;
+    return 1;
+}
+
+/* States of M1. The instructions working on a register pair or the stack pointer before their next
+ * cycle take 5 on the 8080 and 6 on the 8085, the 8080 also takes 5 for the register to register
+ * moves, increments and decrements */
+static unsigned fetchStates(uint8_t opCode, bool is8085) {
+    bool pair = (opCode & 0xC7) == 0x03 || (opCode & 0xC7) == 0xC0 || (opCode & 0xC7) == 0xC4 ||
+                (opCode & 0xC7) == 0xC7 || (opCode & 0xCF) == 0xC5 || (opCode & 0xCF) == 0xCD ||
+                opCode == 0xE9 || opCode == 0xF9;
+    if (pair)
+        return is8085 ? 6 : 5;
+
+    bool memory = (opCode & 0x07) == 0x06 || (opCode & 0x38) == 0x30;
+    bool move = opCode >= 0x40 && opCode < 0x80;
+    bool step = (opCode & 0xC6) == 0x04;
+    if (!is8085 && (move || step) && !memory)
+        return 5;
+    return 4;
+}
+
+/* States with no bus cycle: the two of DAD adding the pair, and the last write of XTHL on the 8080 */
+static unsigned internalStates(uint8_t opCode, bool is8085) {
+    if ((opCode & 0xCF) == 0x09)
+        return 6;
+    if (opCode == 0xE3 && !is8085)
+        return 2;
+    return 0;
+}
+
+/* States the tables leave out when a conditional jump, call or return is taken */
+static unsigned takenStates(uint8_t opCode, bool is8085, uint16_t pc, uint16_t next) {
+    int length = instructionLength(opCode);
+    if ((opCode & 0xC7) == 0xC2 && next != static_cast<uint16_t>(pc + length))
+        return is8085 ? 3 : 0;
+    if ((opCode & 0xC7) == 0xC4 && next != static_cast<uint16_t>(pc + length))
+        return is8085 ? 9 : 6;
+    if ((opCode & 0xC7) == 0xC0 && next != static_cast<uint16_t>(pc + length))
+        return 6;
+    return 0;
+}
+
+static void report(const char* cpuName, uint8_t opCode, unsigned waits, const char* what, uint64_t got,
+                   uint64_t expected) {
+    if (failures < 20) {
+        printf("FAILED: %s opcode %02X with %u wait states: %s %llu, expected %llu\n", cpuName, opCode, waits, what,
+               static_cast<unsigned long long>(got), static_cast<unsigned long long>(expected));
+    }
+    ++failures;
+}
+
+template <class Policies>
+static void testOpcodes(const char* cpuName, const uint8_t* table, bool is8085, unsigned waits) {
+    std::mt19937 random(0x8080);
+    BusLog log;
+    log.waits = waits;
+
+    std::vector<uint8_t> memory(0x10000);
+    for (size_t i = 0; i < 0x10000; i++)
+        memory[i] = static_cast<uint8_t>(random());
+
+    for (int opCode = 0; opCode < 256; opCode++) {
+        /* A halted CPU stops fetching, HLT is timed by the halt tests */
+        if (opCode == 0x76)
+            continue;
+
+        for (int run = 0; run < runsPerOpcode; run++) {
+            /* Jumps and calls go to the operand address, returns to the address on the stack, neither
+             * of them the next instruction, so whether the branch was taken shows in the program counter */
+            memory[programAddress] = static_cast<uint8_t>(opCode);
+            memory[programAddress + 1] = operandAddress & 0xFF;
+            memory[programAddress + 2] = operandAddress >> 8;
+            memory[stackAddress] = returnAddress & 0xFF;
+            memory[stackAddress + 1] = returnAddress >> 8;
+
+            CpuState state;
+            state.a = random();
+            state.b = random();
+            state.c = random();
+            state.d = random();
+            state.e = random();
+            state.h = 0x60;
+            state.l = random();
+            state.sp = stackAddress;
+            state.pc = programAddress;
+            state.cc.z = random() & 1;
+            state.cc.s = random() & 1;
+            state.cc.p = random() & 1;
+            state.cc.cy = random() & 1;
+            state.cc.ac = random() & 1;
+
+            Emulator8080<Policies> cpu(memory.data());
+            cpu.SetState(state);
+            cpu.SetBusHandler(recordCycle, &log);
+            log.kinds.clear();
+            log.clocks.clear();
+            cpu.Emulate();
+
+            uint16_t next = cpu.ProgramCounter();
+            uint64_t expected = table[opCode] + takenStates(opCode, is8085, programAddress, next);
+
+            /* Cycle after cycle from the first state of the instruction */
+            if (log.kinds.empty() || log.kinds[0] != BusCycle::Fetch) {
+                report(cpuName, opCode, waits, "first cycle", log.kinds.empty() ? 0 : static_cast<int>(log.kinds[0]),
+                       static_cast<int>(BusCycle::Fetch));
+                break;
+            }
+            uint64_t clock = 0;
+            bool contiguous = true;
+            for (size_t i = 0; i < log.kinds.size(); i++) {
+                if (log.clocks[i] != clock) {
+                    report(cpuName, opCode, waits, "cycle starting at state", log.clocks[i], clock);
+                    contiguous = false;
+                    break;
+                }
+                clock += (log.kinds[i] == BusCycle::Fetch ? fetchStates(opCode, is8085) : 3) + waits;
+            }
+            if (!contiguous)
+                break;
+
+            uint64_t states = clock - waits * log.kinds.size() + internalStates(opCode, is8085);
+            if (states != expected) {
+                report(cpuName, opCode, waits, "machine cycle states", states, expected);
+                break;
+            }
+            if (cpu.Cycles() != expected + waits * log.kinds.size()) {
+                report(cpuName, opCode, waits, "instruction states", cpu.Cycles(), expected + waits * log.kinds.size());
+                break;
+            }
+        }
+    }
+}
+
+int main() {
+    for (unsigned waits : { 0u, 2u }) {
+        testOpcodes<BusTimingPolicies>("8080", cycles8080, false, waits);
+        testOpcodes<BusTiming8085Policies>("8085", cycles8085, true, waits);
+    }
+
+    printf("%s\n", failures ? "Bus timing tests FAILED" : "Bus timing tests passed");
+    return failures ? 1 : 0;
+}
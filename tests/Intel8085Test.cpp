@@ -0,0 +1,128 @@
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "Emulator8080.h"
+#include "TestSupport.h"
+
+/* Checks of the 8085 additions to the core: the bit layout of RIM and SIM, the instruction EI lets
+ * run before an interrupt is taken, and TRAP getting through DI to wake a halted CPU */
+
+using Cpu8085 = Emulator8080<Intel8085Policies>;
+
+/* RIM: SID in bit 7, the pending RST 7.5, 6.5 and 5.5 in bits 6-4, the interrupt enable in bit 3 and
+ * the masks in bits 2-0. SIM: the masks when bit 3 is set, RST 7.5 cleared by bit 4, SOD from bit 7
+ * when bit 6 is set */
+static void testInterruptMask() {
+    std::vector<uint8_t> memory(0x10000);
+    load(memory, 0x0000, {
+        0xFB,               /* EI */
+        0x20,               /* RIM */
+        0xF3,               /* DI */
+        0x20,               /* RIM */
+        0x3E, 0x1A,         /* MVI A,1AH: masks 010, clear RST 7.5 */
+        0x30,               /* SIM */
+        0x20,               /* RIM */
+        0x3E, 0xC0,         /* MVI A,C0H: SOD on */
+        0x30,               /* SIM */
+        0x3E, 0x05,         /* MVI A,05H: no mask enable, SOD left alone */
+        0x30,               /* SIM */
+        0x20,               /* RIM */
+        0x3E, 0x40,         /* MVI A,40H: SOD off */
+        0x30                /* SIM */
+    });
+    Cpu8085 cpu(memory.data());
+
+    cpu.SetSerialInput(true);
+    cpu.Emulate();
+    cpu.Emulate();
+    check(cpu.State().a == 0x8F, "RIM reads SID, the interrupt enable and the reset masks");
+
+    cpu.SetSerialInput(false);
+    cpu.SetInterruptLine(InterruptLine8085::Rst55, true);
+    cpu.SetInterruptLine(InterruptLine8085::Rst65, true);
+    cpu.SetInterruptLine(InterruptLine8085::Rst75, true);
+    cpu.Emulate();
+    cpu.Emulate();
+    check(cpu.State().a == 0x77, "RIM reads the pending interrupts in bits 6-4");
+
+    cpu.SetInterruptLine(InterruptLine8085::Rst55, false);
+    cpu.SetInterruptLine(InterruptLine8085::Rst65, false);
+    cpu.Emulate();
+    cpu.Emulate();
+    cpu.Emulate();
+    check(cpu.State().a == 0x02, "SIM sets the masks and clears a pending RST 7.5");
+    check((cpu.State().interruptMasks & 0x07) == 0x02, "SIM masks in the CPU state");
+
+    cpu.Emulate();
+    cpu.Emulate();
+    check(cpu.SerialOutput(), "SIM sets SOD with bit 6");
+
+    cpu.Emulate();
+    cpu.Emulate();
+    cpu.Emulate();
+    check(cpu.SerialOutput(), "SIM leaves SOD without bit 6");
+    check(cpu.State().a == 0x02, "SIM leaves the masks without bit 3");
+
+    cpu.Emulate();
+    cpu.Emulate();
+    check(!cpu.SerialOutput(), "SIM clears SOD with bit 6");
+}
+
+/* An interrupt pending when EI runs is taken after the instruction following it, not before */
+static void testEnableDelay() {
+    std::vector<uint8_t> memory(0x10000);
+    load(memory, 0x0000, {
+        0xF3,               /* DI */
+        0x31, 0x00, 0x10,   /* LXI SP,1000H */
+        0x3E, 0x08,         /* MVI A,08H: unmask RST 5.5-7.5 */
+        0x30,               /* SIM */
+        0xFB,               /* EI */
+        0x04,               /* INR B */
+        0x04,               /* INR B */
+        0x76                /* HLT */
+    });
+    load(memory, 0x0034, { 0x76 });     /* RST 6.5: HLT */
+    Cpu8085 cpu(memory.data());
+
+    cpu.SetInterruptLine(InterruptLine8085::Rst65, true);
+    StopReason reason = cpu.RunUntil(1000);
+    CpuState state = cpu.State();
+    check(reason == StopReason::Halt, "RST 6.5 handler halts with interrupts disabled");
+    check(state.b == 1, "one instruction runs after EI before the interrupt");
+    check(state.sp == 0x0FFE && stackWord(memory, state.sp) == 0x0009, "RST 6.5 returns after the first INR");
+}
+
+/* TRAP is taken with interrupts disabled, resuming a halted CPU after its HLT, and only once per edge */
+static void testTrap() {
+    std::vector<uint8_t> memory(0x10000);
+    load(memory, 0x0000, {
+        0x31, 0x00, 0x10,   /* LXI SP,1000H */
+        0xF3,               /* DI */
+        0x76,               /* HLT */
+        0x0C,               /* INR C */
+        0x76                /* HLT */
+    });
+    load(memory, 0x0024, { 0x04, 0xC9 });   /* TRAP: INR B; RET */
+    Cpu8085 cpu(memory.data());
+
+    check(cpu.RunUntil(1000) == StopReason::Halt, "HLT after DI stops the run");
+    check(cpu.Halted(), "CPU halted");
+
+    cpu.SetInterruptLine(InterruptLine8085::Trap, true);
+    StopReason reason = cpu.RunUntil(cpu.Cycles() + 1000);
+    CpuState state = cpu.State();
+    check(reason == StopReason::Halt, "TRAP handler returns to the second HLT");
+    check(state.b == 1, "TRAP taken once through DI");
+    check(state.c == 1, "TRAP returns after the HLT it woke");
+    check(state.sp == 0x1000 && stackWord(memory, 0x0FFE) == 0x0005, "TRAP pushes the address after the HLT");
+}
+
+int main() {
+    testInterruptMask();
+    testEnableDelay();
+    testTrap();
+
+    printf("%s\n", failures ? "8085 tests FAILED" : "8085 tests passed");
+    return failures ? 1 : 0;
+}
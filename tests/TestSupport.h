@@ -0,0 +1,31 @@
+#ifndef TESTSUPPORT_H
+#define TESTSUPPORT_H
+
+#include <cstdint>
+#include <cstdio>
+#include <initializer_list>
+#include <vector>
+
+/* Helpers shared by the test executables. A test counts its failures and returns nonzero when any happened */
+
+inline int failures = 0;
+
+inline void check(bool condition, const char* what) {
+    if (!condition) {
+        printf("FAILED: %s\n", what);
+        ++failures;
+    }
+}
+
+/* Put a program or data into memory at the address */
+inline void load(std::vector<uint8_t>& memory, uint16_t address, std::initializer_list<uint8_t> bytes) {
+    for (uint8_t byte : bytes)
+        memory[address++] = byte;
+}
+
+/* The little-endian word at the stack pointer */
+inline uint16_t stackWord(const std::vector<uint8_t>& memory, uint16_t sp) {
+    return memory[sp] | (memory[sp + 1] << 8);
+}
+
+#endif
@@ -0,0 +1,189 @@
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "Emulator8080.h"
+#include "TestSupport.h"
+
+/* Smoke test of the Z80 core: a few instructions of every prefix with their results, flags and
+ * states, then the mode 2 interrupt through the vector table and the NMI with RETN */
+
+using CpuZ80 = Emulator8080<Z80Policies>;
+
+static void run(CpuZ80& cpu, int instructions) {
+    for (int i = 0; i < instructions; i++)
+        cpu.Emulate();
+}
+
+/* CB: rotations, BIT, SET and RES on registers and on (HL) */
+static void testBitInstructions() {
+    std::vector<uint8_t> memory(0x10000);
+    load(memory, 0x0000, {
+        0x06, 0x81,         /* LD B,81H */
+        0xCB, 0x00,         /* RLC B */
+        0xCB, 0x78,         /* BIT 7,B */
+        0x21, 0x00, 0x40,   /* LD HL,4000H */
+        0xCB, 0xFE,         /* SET 7,(HL) */
+        0xCB, 0x86,         /* RES 0,(HL) */
+        0xCB, 0x3E          /* SRL (HL) */
+    });
+    memory[0x4000] = 0x0F;
+    CpuZ80 cpu(memory.data());
+
+    run(cpu, 2);
+    CpuState state = cpu.State();
+    check(state.b == 0x03 && state.cc.cy == 1, "RLC B rotates bit 7 into bit 0 and the carry");
+    run(cpu, 1);
+    check(cpu.State().cc.z == 1, "BIT 7,B sets Z for a clear bit");
+    check(cpu.Cycles() == 7 + 8 + 8, "CB register instructions take 8 states");
+
+    run(cpu, 4);
+    state = cpu.State();
+    check(memory[0x4000] == 0x47 && state.cc.cy == 0, "SET, RES and SRL on (HL)");
+    check(cpu.Cycles() == 23 + 10 + 15 + 15 + 15, "CB (HL) instructions take 15 states");
+}
+
+/* DD and FD: IX and IY loads, indexed operands, the IX halves and DD CB */
+static void testIndexInstructions() {
+    std::vector<uint8_t> memory(0x10000);
+    load(memory, 0x0000, {
+        0xDD, 0x21, 0x00, 0x30,     /* LD IX,3000H */
+        0xDD, 0x36, 0x05, 0x42,     /* LD (IX+5),42H */
+        0xDD, 0x7E, 0x05,           /* LD A,(IX+5) */
+        0xDD, 0x34, 0x05,           /* INC (IX+5) */
+        0xDD, 0xCB, 0x05, 0xDE,     /* SET 3,(IX+5) */
+        0xFD, 0x21, 0x10, 0x30,     /* LD IY,3010H */
+        0xFD, 0x46, 0xF5,           /* LD B,(IY-0BH) */
+        0xDD, 0x26, 0x12,           /* LD IXH,12H */
+        0xDD, 0x7D                  /* LD A,IXL */
+    });
+    CpuZ80 cpu(memory.data());
+
+    run(cpu, 3);
+    check(cpu.State().a == 0x42, "LD A,(IX+d) reads the byte LD (IX+d),n wrote");
+    run(cpu, 2);
+    check(memory[0x3005] == 0x4B, "INC (IX+d) and SET b,(IX+d)");
+    check(cpu.Cycles() == 14 + 19 + 19 + 23 + 23, "indexed instruction states");
+
+    run(cpu, 2);
+    CpuState state = cpu.State();
+    check(state.iy == 0x3010 && state.b == 0x4B, "LD r,(IY+d) with a negative displacement");
+
+    run(cpu, 2);
+    state = cpu.State();
+    check(state.ix == 0x1200 && state.a == 0x00, "LD IXH,n and LD A,IXL");
+    check(state.pc == 0x001E, "program counter after the prefixed instructions");
+}
+
+/* ED: block transfer, NEG and 16-bit subtraction with the Z80 flags */
+static void testExtendedInstructions() {
+    std::vector<uint8_t> memory(0x10000);
+    load(memory, 0x0000, {
+        0x21, 0x00, 0x10,   /* LD HL,1000H */
+        0x11, 0x00, 0x20,   /* LD DE,2000H */
+        0x01, 0x03, 0x00,   /* LD BC,0003H */
+        0xED, 0xB0,         /* LDIR */
+        0x3E, 0x01,         /* LD A,01H */
+        0xED, 0x44,         /* NEG */
+        0x21, 0x00, 0x00,   /* LD HL,0000H */
+        0x01, 0x01, 0x00,   /* LD BC,0001H */
+        0xB7,               /* OR A */
+        0xED, 0x42          /* SBC HL,BC */
+    });
+    load(memory, 0x1000, { 1, 2, 3 });
+    CpuZ80 cpu(memory.data());
+
+    run(cpu, 6);
+    CpuState state = cpu.State();
+    check(memory[0x2000] == 1 && memory[0x2001] == 2 && memory[0x2002] == 3, "LDIR copies the block");
+    check(state.b == 0 && state.c == 0 && state.h == 0x10 && state.l == 0x03 && state.pc == 0x000B,
+          "LDIR repeats until BC is zero");
+    check(cpu.Cycles() == 10 + 10 + 10 + 21 + 21 + 16, "LDIR takes 21 states a byte and 16 for the last");
+
+    run(cpu, 2);
+    state = cpu.State();
+    check(state.a == 0xFF && state.cc.s == 1 && state.cc.cy == 1 && state.cc.n == 1, "NEG of 1");
+
+    run(cpu, 4);
+    state = cpu.State();
+    check(state.h == 0xFF && state.l == 0xFF && state.cc.cy == 1 && state.cc.n == 1, "SBC HL,BC borrows");
+}
+
+/* Mode 2 takes the handler address from the table at I, indexed by the vector the device puts on the
+ * bus, waking the CPU from HALT. RETI returns after the HALT */
+static void testInterruptMode2() {
+    std::vector<uint8_t> memory(0x10000);
+    load(memory, 0x0000, {
+        0xF3,               /* DI */
+        0x31, 0x00, 0x80,   /* LD SP,8000H */
+        0x3E, 0x40,         /* LD A,40H */
+        0xED, 0x47,         /* LD I,A */
+        0xED, 0x5E,         /* IM 2 */
+        0xFB,               /* EI */
+        0x76,               /* HALT */
+        0x0C                /* INC C */
+    });
+    load(memory, 0x40FF, { 0x00, 0x02 });            /* vector FFH: 0200H */
+    load(memory, 0x0200, { 0x04, 0xFB, 0xED, 0x4D });   /* INC B; EI; RETI */
+    CpuZ80 cpu(memory.data());
+
+    run(cpu, 7);
+    check(cpu.Halted(), "HALT waits for the interrupt");
+    CpuState state = cpu.State();
+    check(state.interruptMode == 2 && state.i == 0x40, "IM 2 and LD I,A");
+
+    uint64_t before = cpu.Cycles();
+    cpu.GenerateInterrupt(7);
+    state = cpu.State();
+    check(state.pc == 0x0200 && !state.halted, "mode 2 jumps through the vector table");
+    check(state.sp == 0x7FFE && stackWord(memory, state.sp) == 0x000C, "mode 2 pushes the address after HALT");
+    check(cpu.Cycles() - before == 19, "mode 2 interrupt takes 19 states");
+
+    run(cpu, 4);
+    state = cpu.State();
+    check(state.b == 1 && state.c == 1 && state.sp == 0x8000 && state.intEnable, "RETI returns with EI");
+}
+
+/* The NMI is taken through DI, RETN restores the interrupt enable it saved */
+static void testNmi() {
+    std::vector<uint8_t> memory(0x10000);
+    load(memory, 0x0000, {
+        0x31, 0x00, 0x80,   /* LD SP,8000H */
+        0xFB,               /* EI */
+        0x00,               /* NOP */
+        0xF3,               /* DI */
+        0x00                /* NOP */
+    });
+    load(memory, 0x0066, { 0x04, 0xED, 0x45 });   /* INC B; RETN */
+    CpuZ80 cpu(memory.data());
+
+    run(cpu, 2);
+    uint64_t before = cpu.Cycles();
+    cpu.GenerateNmi();
+    CpuState state = cpu.State();
+    check(state.pc == 0x0066 && !state.intEnable && state.iff2, "NMI saves the interrupt enable in IFF2");
+    check(cpu.Cycles() - before == 11, "NMI takes 11 states");
+
+    run(cpu, 2);
+    state = cpu.State();
+    check(state.b == 1 && state.pc == 0x0004 && state.intEnable, "RETN restores the interrupt enable");
+
+    run(cpu, 2);
+    cpu.GenerateInterrupt(7);
+    check(cpu.State().pc == 0x0006, "DI masks the maskable interrupt");
+    cpu.GenerateNmi();
+    run(cpu, 2);
+    state = cpu.State();
+    check(state.b == 2 && state.pc == 0x0006 && !state.intEnable, "NMI taken through DI, RETN keeps it off");
+}
+
+int main() {
+    testBitInstructions();
+    testIndexInstructions();
+    testExtendedInstructions();
+    testInterruptMode2();
+    testNmi();
+
+    printf("%s\n", failures ? "Z80 tests FAILED" : "Z80 tests passed");
+    return failures ? 1 : 0;
+}